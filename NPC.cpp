@@ -9,8 +9,16 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include "dsa_stats.h"
 using namespace std;
 
+struct GridPathResult
+{
+    vector<pair<int, int>> path; // Start to goal inclusive; empty when the goal is unreachable
+    int cost = INT_MAX;
+    SearchStats stats;
+};
+
 class GridGraph
 {
 private:
@@ -70,8 +78,10 @@ public:
         return neighbors;
     }
 
-    void aStarPathfinding(pair<int, int> start, pair<int, int> goal)
+    GridPathResult aStarPathfinding(pair<int, int> start, pair<int, int> goal)
     {
+        GridPathResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         auto heuristic = [&](int x1, int y1, int x2, int y2)
         {
             return abs(x1 - x2) + abs(y1 - y2);
@@ -82,6 +92,7 @@ public:
         vector<vector<pair<int, int>>> parents(rows, vector<pair<int, int>>(cols, {-1, -1}));
 
         pq.push({start.first, start.second, 0});
+        DSA_STAT(result.stats.heapPushes++);
         cost[start.first][start.second] = 0;
 
         while (!pq.empty())
@@ -89,6 +100,14 @@ public:
             Node current = pq.top();
             pq.pop();
 
+            // Skip entries superseded by a cheaper path found after they were pushed
+            if (current.cost > cost[current.x][current.y] + heuristic(current.x, current.y, goal.first, goal.second))
+            {
+                DSA_STAT(result.stats.stalePops++);
+                continue;
+            }
+            DSA_STAT(result.stats.nodesSettled++);
+
             if (current.x == goal.first && current.y == goal.second)
             {
                 break;
@@ -99,39 +118,34 @@ public:
                 int nx = neighbor.first;
                 int ny = neighbor.second;
                 int newCost = cost[current.x][current.y] + 1;
+                DSA_STAT(result.stats.edgesRelaxed++);
 
                 if (newCost < cost[nx][ny])
                 {
                     cost[nx][ny] = newCost;
                     parents[nx][ny] = {current.x, current.y};
                     pq.push({nx, ny, newCost + heuristic(nx, ny, goal.first, goal.second)});
+                    DSA_STAT(result.stats.heapPushes++);
                 }
             }
         }
 
-        if (cost[goal.first][goal.second] == INT_MAX)
-        {
-            cout << "No path found from start to goal.\n";
-            return;
-        }
-
-        // Trace the path
-        vector<pair<int, int>> path;
-        for (pair<int, int> at = goal; at != make_pair(-1, -1); at = parents[at.first][at.second])
-        {
-            path.push_back(at);
-        }
-        reverse(path.begin(), path.end());
-
-        cout << "Path found: \n";
-        for (const auto &p : path)
+        result.cost = cost[goal.first][goal.second];
+        if (result.cost != INT_MAX)
         {
-            cout << "(" << p.first << ", " << p.second << ") ";
+            // Trace the path
+            for (pair<int, int> at = goal; at != make_pair(-1, -1); at = parents[at.first][at.second])
+            {
+                result.path.push_back(at);
+            }
+            reverse(result.path.begin(), result.path.end());
         }
-        cout << endl;
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     int rows = 5, cols = 5;
@@ -149,7 +163,24 @@ int main()
     // Perform A* Pathfinding
     pair<int, int> start = {0, 0};
     pair<int, int> goal = {4, 4};
-    gameGrid.aStarPathfinding(start, goal);
+    GridPathResult result = gameGrid.aStarPathfinding(start, goal);
+    if (result.path.empty())
+    {
+        cout << "No path found from start to goal.\n";
+    }
+    else
+    {
+        cout << "Path found: \n";
+        for (const auto &p : result.path)
+        {
+            cout << "(" << p.first << ", " << p.second << ") ";
+        }
+        cout << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(result.stats);
+#endif
     system("pause");
     return 0;
 }
+#endif
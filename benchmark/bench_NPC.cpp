@@ -0,0 +1,25 @@
+// Benchmarks for NPC.cpp: corner-to-corner aStarPathfinding on a random obstacle map
+#define DSA_LAB_NO_MAIN
+#include "../NPC.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+    int side = 512 * (int)sqrt((double)options.scale);
+    vector<vector<char>> map = generateObstacleMap(side, side, 0.25, options.seed);
+
+    GridGraph grid(side, side);
+    for (int x = 0; x < side; ++x)
+        for (int y = 0; y < side; ++y)
+            if (map[x][y])
+                grid.setObstacle(x, y);
+
+    SearchStats last;
+    reportBenchmark("NPC", "aStarPathfinding", "grid=" + to_string(side) + "x" + to_string(side) + " obstacles=0.25",
+                    runBenchmark(options, [&](int)
+                                 { last = grid.aStarPathfinding({0, 0}, {side - 1, side - 1}).stats; }),
+                    1);
+    DSA_STAT(reportCounters("NPC", "aStarPathfinding", last));
+    return 0;
+}
@@ -0,0 +1,43 @@
+// Benchmarks for city_model.cpp: findTrafficBottlenecks and findAlternativeRoutes on a road-like grid
+#define DSA_LAB_NO_MAIN
+#include "../city_model.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+
+    // Edge betweenness runs a search from every intersection, so it gets a smaller city
+    int side = 24 * (int)sqrt((double)options.scale);
+    vector<WeightedEdge> small = generateGrid(side, side, options.seed);
+    Graph city;
+    for (int v = 0; v < side * side; ++v)
+        city.addVertex();
+    for (const auto &e : small)
+        city.addEdge(e.u, e.v, e.weight);
+    SearchStats last;
+    reportBenchmark("city_model", "findTrafficBottlenecks", "grid=" + to_string(side) + "x" + to_string(side),
+                    runBenchmark(options, [&](int)
+                                 { last = city.findTrafficBottlenecks().stats; }),
+                    side * side);
+    DSA_STAT(reportCounters("city_model", "findTrafficBottlenecks", last));
+
+    int bigSide = 256 * (int)sqrt((double)options.scale);
+    vector<WeightedEdge> roads = generateGrid(bigSide, bigSide, options.seed);
+    Graph region;
+    for (int v = 0; v < bigSide * bigSide; ++v)
+        region.addVertex();
+    for (const auto &e : roads)
+        region.addEdge(e.u, e.v, e.weight);
+
+    mt19937 rng(options.seed);
+    vector<pair<int, int>> trips(options.warmup + options.reps);
+    for (auto &trip : trips)
+        trip = {int(rng() % (bigSide * bigSide)), int(rng() % (bigSide * bigSide))};
+    reportBenchmark("city_model", "findAlternativeRoutes", "grid=" + to_string(bigSide) + "x" + to_string(bigSide),
+                    runBenchmark(options, [&](int rep)
+                                 { last = region.findAlternativeRoutes(trips[rep].first, trips[rep].second).stats; }),
+                    1);
+    DSA_STAT(reportCounters("city_model", "findAlternativeRoutes", last));
+    return 0;
+}
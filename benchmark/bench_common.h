@@ -0,0 +1,218 @@
+// Shared pieces of the benchmark drivers: synthetic input generators, a timing
+// harness with warm-up and repetitions, and one JSON object per line of output.
+//
+// Each driver includes exactly one lab program with DSA_LAB_NO_MAIN defined, e.g.
+//   g++ -std=c++17 -O2 -pthread benchmark/bench_graph.cpp -o bench_graph
+//   ./bench_graph --scale 4 --reps 20 --warmup 2 --seed 7 >> results.jsonl
+// benchmark/run_all.sh builds and runs every driver. Adding -DDSA_LAB_INSTRUMENT also
+// prints the search counters of each benchmark's last run.
+#pragma once
+
+#include <iostream>
+#include <streambuf>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <set>
+
+struct BenchOptions
+{
+    int scale = 1;  // Multiplies every generator's base size
+    int reps = 10;  // Timed repetitions per benchmark
+    int warmup = 1; // Untimed runs before the timed ones
+    unsigned seed = 12345;
+};
+
+inline BenchOptions parseBenchOptions(int argc, char **argv)
+{
+    BenchOptions options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        int value = std::atoi(argv[i + 1]);
+        if (!std::strcmp(argv[i], "--scale"))
+            options.scale = std::max(1, value);
+        else if (!std::strcmp(argv[i], "--reps"))
+            options.reps = std::max(1, value);
+        else if (!std::strcmp(argv[i], "--warmup"))
+            options.warmup = std::max(0, value);
+        else if (!std::strcmp(argv[i], "--seed"))
+            options.seed = (unsigned)value;
+        else
+            std::cerr << "Unknown option " << argv[i] << "\n";
+    }
+    return options;
+}
+
+// Discards everything written to cout while alive, so timings measure the algorithm rather than the console
+class SilenceCout
+{
+    std::streambuf *saved;
+
+public:
+    SilenceCout() : saved(std::cout.rdbuf(nullptr)) {}
+    ~SilenceCout()
+    {
+        std::cout.rdbuf(saved);
+        std::cout.clear();
+    }
+};
+
+struct BenchStats
+{
+    std::vector<double> samplesMs; // Sorted ascending
+    double meanMs = 0;
+
+    double percentile(double p) const
+    {
+        size_t rank = (size_t)std::ceil(p / 100.0 * samplesMs.size());
+        return samplesMs[std::min(samplesMs.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+};
+
+// Run fn(rep) warmup times untimed, then reps times timed; rep lets a driver vary the query per run
+template <typename Fn>
+BenchStats runBenchmark(const BenchOptions &options, Fn fn)
+{
+    BenchStats stats;
+    SilenceCout silence;
+    for (int rep = 0; rep < options.warmup; ++rep)
+        fn(rep);
+    for (int rep = 0; rep < options.reps; ++rep)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        fn(options.warmup + rep);
+        auto end = std::chrono::steady_clock::now();
+        stats.samplesMs.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+    std::sort(stats.samplesMs.begin(), stats.samplesMs.end());
+    for (double sample : stats.samplesMs)
+        stats.meanMs += sample / stats.samplesMs.size();
+    return stats;
+}
+
+// One JSON object per line; itemsPerRun (edges, queries, cells, ...) turns latency into throughput
+inline void reportBenchmark(const char *module, const char *name, const std::string &params,
+                            const BenchStats &stats, double itemsPerRun)
+{
+    std::printf("{\"module\":\"%s\",\"benchmark\":\"%s\",\"params\":\"%s\",\"reps\":%zu,"
+                "\"mean_ms\":%.4f,\"min_ms\":%.4f,\"p50_ms\":%.4f,\"p90_ms\":%.4f,\"p99_ms\":%.4f,\"max_ms\":%.4f,"
+                "\"items_per_sec\":%.1f}\n",
+                module, name, params.c_str(), stats.samplesMs.size(), stats.meanMs, stats.samplesMs.front(),
+                stats.percentile(50), stats.percentile(90), stats.percentile(99), stats.samplesMs.back(),
+                stats.meanMs > 0 ? itemsPerRun * 1000.0 / stats.meanMs : 0.0);
+    std::fflush(stdout);
+}
+
+#ifdef DSA_LAB_INSTRUMENT
+// Search counters of the last timed run as their own JSON line; SearchStats comes from dsa_stats.h via the lab program
+inline void reportCounters(const char *module, const char *name, const SearchStats &stats)
+{
+    std::printf("{\"module\":\"%s\",\"benchmark\":\"%s\",\"nodes_settled\":%lld,\"edges_relaxed\":%lld,"
+                "\"heap_pushes\":%lld,\"stale_pops\":%lld,\"iterations\":%lld,\"wall_ms\":%.4f}\n",
+                module, name, stats.nodesSettled, stats.edgesRelaxed, stats.heapPushes, stats.stalePops,
+                stats.iterations, stats.wallMs);
+    std::fflush(stdout);
+}
+#endif
+
+struct WeightedEdge
+{
+    int u, v, weight;
+};
+
+// R-MAT power-law graph on 2^scaleLog2 vertices; self-loops and duplicates removed when simple is set
+inline std::vector<WeightedEdge> generateRMAT(int scaleLog2, int edgeFactor, unsigned seed, bool simple = true,
+                                             double a = 0.57, double b = 0.19, double c = 0.19)
+{
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<int> weight(1, 100);
+    size_t numEdges = ((size_t)1 << scaleLog2) * edgeFactor;
+    std::vector<WeightedEdge> edges;
+    std::set<std::pair<int, int>> seen;
+    for (size_t e = 0; e < numEdges; ++e)
+    {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scaleLog2; ++bit)
+        {
+            double r = coin(rng);
+            int right = r >= a && (r < a + b || r >= a + b + c);
+            int down = r >= a + b;
+            u |= down << bit;
+            v |= right << bit;
+        }
+        if (simple)
+        {
+            if (u == v || !seen.insert({std::min(u, v), std::max(u, v)}).second)
+                continue;
+        }
+        edges.push_back({u, v, weight(rng)});
+    }
+    return edges;
+}
+
+// Road-like grid: 4-neighbour streets with travel times in [1, 10] and a few random long-range shortcuts
+inline std::vector<WeightedEdge> generateGrid(int rows, int cols, unsigned seed, double shortcutRate = 0.01)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 10);
+    std::uniform_int_distribution<int> anyVertex(0, rows * cols - 1);
+    std::vector<WeightedEdge> edges;
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+        {
+            int v = r * cols + c;
+            if (c + 1 < cols)
+                edges.push_back({v, v + 1, weight(rng)});
+            if (r + 1 < rows)
+                edges.push_back({v, v + cols, weight(rng)});
+        }
+    size_t shortcuts = (size_t)(shortcutRate * rows * cols);
+    for (size_t s = 0; s < shortcuts; ++s)
+    {
+        int u = anyVertex(rng), v = anyVertex(rng);
+        if (u != v)
+            edges.push_back({u, v, 10 * weight(rng)});
+    }
+    return edges;
+}
+
+// User-item interactions with Zipf-like item popularity (exponent skew) and uniform users
+inline std::vector<std::pair<int, int>> generateInteractions(int users, int items, size_t count, unsigned seed,
+                                                             double skew = 1.0)
+{
+    std::mt19937_64 rng(seed);
+    std::vector<double> cumulative(items);
+    double total = 0;
+    for (int i = 0; i < items; ++i)
+        cumulative[i] = total += 1.0 / std::pow(i + 1.0, skew);
+    std::uniform_real_distribution<double> pick(0.0, total);
+    std::uniform_int_distribution<int> anyUser(0, users - 1);
+
+    std::vector<std::pair<int, int>> interactions(count);
+    for (auto &interaction : interactions)
+    {
+        int item = std::lower_bound(cumulative.begin(), cumulative.end(), pick(rng)) - cumulative.begin();
+        interaction = {anyUser(rng), std::min(item, items - 1)};
+    }
+    return interactions;
+}
+
+// Random obstacle map (1 = blocked) with the corners kept free for start and goal
+inline std::vector<std::vector<char>> generateObstacleMap(int rows, int cols, double density, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution blocked(density);
+    std::vector<std::vector<char>> map(rows, std::vector<char>(cols, 0));
+    for (auto &row : map)
+        for (auto &cell : row)
+            cell = blocked(rng);
+    map[0][0] = map[rows - 1][cols - 1] = 0;
+    return map;
+}
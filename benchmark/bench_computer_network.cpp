@@ -0,0 +1,30 @@
+// Benchmarks for computer_network.cpp: findCriticalConnections and optimizeTopology on an R-MAT network
+#define DSA_LAB_NO_MAIN
+#include "../computer_network.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+    int scaleLog2 = 14 + (int)log2(options.scale);
+    int n = 1 << scaleLog2;
+    vector<WeightedEdge> links = generateRMAT(scaleLog2, 4, options.seed);
+
+    NetworkGraph network;
+    for (int v = 0; v < n; ++v)
+        network.addDevice();
+    for (const auto &e : links)
+        network.addConnection(e.u, e.v, e.weight);
+    string params = "n=" + to_string(n) + " m=" + to_string(links.size());
+
+    SearchStats last;
+    reportBenchmark("computer_network", "findCriticalConnections", params, runBenchmark(options, [&](int)
+                                                                                       { last = network.findCriticalConnections().stats; }),
+                    links.size());
+    DSA_STAT(reportCounters("computer_network", "findCriticalConnections", last));
+    reportBenchmark("computer_network", "optimizeTopology", params, runBenchmark(options, [&](int)
+                                                                                { last = network.optimizeTopology().stats; }),
+                    links.size());
+    DSA_STAT(reportCounters("computer_network", "optimizeTopology", last));
+    return 0;
+}
@@ -0,0 +1,44 @@
+// Benchmarks for graph.cpp: dijkstra, aStar and pageRank on a directed R-MAT graph
+#define DSA_LAB_NO_MAIN
+#include "../graph.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+    int scaleLog2 = 14 + (int)log2(options.scale);
+    int n = 1 << scaleLog2;
+    vector<WeightedEdge> edges = generateRMAT(scaleLog2, 8, options.seed, false);
+
+    Graph g;
+    for (int v = 0; v < n; ++v)
+        g.addVertex();
+    for (const auto &e : edges)
+        g.addEdge(e.u, e.v, e.weight);
+    string params = "n=" + to_string(n) + " m=" + to_string(edges.size());
+
+    mt19937 rng(options.seed);
+    // Sources are drawn from edge tails; most R-MAT vertices have no out-edges
+    vector<int> sources(options.warmup + options.reps);
+    for (int &s : sources)
+        s = edges[rng() % edges.size()].u;
+
+    SearchStats last;
+    reportBenchmark("graph", "dijkstra", params, runBenchmark(options, [&](int rep)
+                                                              { last = g.dijkstra(sources[rep]).stats; }),
+                    edges.size());
+    DSA_STAT(reportCounters("graph", "dijkstra", last));
+
+    // A zero heuristic is admissible on any graph, so A* degenerates to goal-directed Dijkstra
+    vector<int> heuristic(n, 0);
+    reportBenchmark("graph", "aStar", params, runBenchmark(options, [&](int rep)
+                                                           { last = g.aStar(sources[rep], sources[(rep + 1) % sources.size()], heuristic).stats; }),
+                    1);
+    DSA_STAT(reportCounters("graph", "aStar", last));
+
+    reportBenchmark("graph", "pageRank", params + " iterations=20", runBenchmark(options, [&](int)
+                                                                                 { last = g.pageRank(0.85, 20).stats; }),
+                    20.0 * edges.size());
+    DSA_STAT(reportCounters("graph", "pageRank", last));
+    return 0;
+}
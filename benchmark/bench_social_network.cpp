@@ -0,0 +1,32 @@
+// Benchmarks for social_network.cpp: detectCommunities and the parallel community/component paths on R-MAT
+#define DSA_LAB_NO_MAIN
+#include "../social_network.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+    int scaleLog2 = 15 + (int)log2(options.scale);
+    int n = 1 << scaleLog2;
+    vector<WeightedEdge> friendships = generateRMAT(scaleLog2, 8, options.seed);
+
+    Graph social;
+    for (int v = 0; v < n; ++v)
+        social.addVertex();
+    for (const auto &e : friendships)
+        social.addEdge(e.u, e.v);
+    string params = "n=" + to_string(n) + " m=" + to_string(friendships.size());
+
+    SearchStats last;
+    reportBenchmark("social_network", "detectCommunities", params, runBenchmark(options, [&](int)
+                                                                               { last = social.detectCommunities().stats; }),
+                    friendships.size());
+    DSA_STAT(reportCounters("social_network", "detectCommunities", last));
+    reportBenchmark("social_network", "connectedComponents", params, runBenchmark(options, [&](int)
+                                                                                 { social.connectedComponents(); }),
+                    friendships.size());
+    reportBenchmark("social_network", "detectModularityCommunities", params, runBenchmark(options, [&](int)
+                                                                                         { social.detectModularityCommunities(); }),
+                    friendships.size());
+    return 0;
+}
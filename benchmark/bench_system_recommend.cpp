@@ -0,0 +1,31 @@
+// Benchmarks for system_recommend.cpp: per-query recommendItems latency on skewed bipartite interactions
+#define DSA_LAB_NO_MAIN
+#include "../system_recommend.cpp"
+#include "bench_common.h"
+
+int main(int argc, char **argv)
+{
+    BenchOptions options = parseBenchOptions(argc, argv);
+    int users = 20000 * options.scale, items = 5000 * options.scale;
+    size_t count = 200000 * (size_t)options.scale;
+
+    RecommendationSystem rs;
+    for (int u = 0; u < users; ++u)
+        rs.addUser();
+    for (int i = 0; i < items; ++i)
+        rs.addItem();
+    for (const auto &interaction : generateInteractions(users, items, count, options.seed))
+        rs.addInteraction(interaction.first, interaction.second);
+    string params = "users=" + to_string(users) + " items=" + to_string(items) + " interactions=" + to_string(count);
+
+    mt19937 rng(options.seed);
+    vector<int> queries(options.warmup + options.reps);
+    for (int &q : queries)
+        q = rng() % users;
+    SearchStats last;
+    reportBenchmark("system_recommend", "recommendItems", params, runBenchmark(options, [&](int rep)
+                                                                              { last = rs.recommendItems(queries[rep]).stats; }),
+                    1);
+    DSA_STAT(reportCounters("system_recommend", "recommendItems", last));
+    return 0;
+}
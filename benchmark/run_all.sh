@@ -0,0 +1,19 @@
+#!/bin/sh
+# Build every benchmark driver and append their JSON lines to the given file (default: stdout).
+# Extra arguments are passed to each driver, e.g. ./benchmark/run_all.sh results.jsonl --scale 4 --reps 20
+set -e
+cd "$(dirname "$0")"
+OUT=${1:--}
+[ $# -gt 0 ] && shift
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -O2 -march=native -pthread}
+mkdir -p bin
+for src in bench_*.cpp; do
+    name=${src%.cpp}
+    $CXX $CXXFLAGS "$src" -o "bin/$name"
+    if [ "$OUT" = "-" ]; then
+        "bin/$name" "$@"
+    else
+        "bin/$name" "$@" >> "$OUT"
+    fi
+done
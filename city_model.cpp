@@ -9,8 +9,22 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include "dsa_stats.h"
 using namespace std;
 
+struct BottleneckResult
+{
+    vector<pair<pair<int, int>, int>> edgeBetweenness; // ((u, v) with u < v, betweenness), ordered by edge
+    SearchStats stats;
+};
+
+struct RouteResult
+{
+    vector<int> route; // Empty when no route exists
+    int distance = INT_MAX;
+    SearchStats stats;
+};
+
 class Graph
 {
 private:
@@ -54,8 +68,10 @@ public:
     }
 
     // Find traffic bottlenecks using edge betweenness
-    void findTrafficBottlenecks()
+    BottleneckResult findTrafficBottlenecks()
     {
+        BottleneckResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         map<pair<int, int>, int> edgeBetweenness;
 
         for (int i = 0; i < numVertices; ++i)
@@ -73,16 +89,19 @@ public:
             {
                 int current = q.front();
                 q.pop();
+                DSA_STAT(result.stats.nodesSettled++);
 
                 for (const auto &neighbor : adjList[current])
                 {
                     int next = neighbor.first;
                     int weight = neighbor.second;
+                    DSA_STAT(result.stats.edgesRelaxed++);
 
                     if (distances[next] > distances[current] + weight)
                     {
                         distances[next] = distances[current] + weight;
                         q.push(next);
+                        DSA_STAT(result.stats.heapPushes++);
                         predecessors[next].clear();
                         predecessors[next].push_back(current);
                         paths[next] = paths[current];
@@ -116,34 +135,37 @@ public:
                     edgeBetweenness[edge] += dependency[node];
                 }
             }
+            DSA_STAT(result.stats.iterations++);
         }
 
-        cout << "Traffic Bottlenecks (Edge Betweenness):\n";
-        for (const auto &entry : edgeBetweenness)
-        {
-            cout << "Edge " << entry.first.first << " - " << entry.first.second << ": " << entry.second << endl;
-        }
+        result.edgeBetweenness.assign(edgeBetweenness.begin(), edgeBetweenness.end());
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 
     // Suggest optimal traffic light timings
-    void suggestTrafficLightTimings()
+    vector<int> suggestTrafficLightTimings()
     {
-        cout << "Traffic Light Timing Suggestions:\n";
+        vector<int> greenSeconds(numVertices);
         for (int i = 0; i < numVertices; ++i)
         {
             int degree = adjList[i].size();
-            cout << "Node " << i << ": " << degree * 10 << " seconds green time." << endl;
+            greenSeconds[i] = degree * 10;
         }
+        return greenSeconds;
     }
 
     // Find alternative routes using Dijkstra's algorithm
-    void findAlternativeRoutes(int start, int end)
+    RouteResult findAlternativeRoutes(int start, int end)
     {
+        RouteResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         vector<int> distances(numVertices, INT_MAX);
         distances[start] = 0;
 
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
         pq.push({0, start});
+        DSA_STAT(result.stats.heapPushes++);
 
         vector<int> parents(numVertices, -1);
 
@@ -153,6 +175,13 @@ public:
             int currentNode = pq.top().second;
             pq.pop();
 
+            if (currentDist > distances[currentNode])
+            {
+                DSA_STAT(result.stats.stalePops++);
+                continue;
+            }
+            DSA_STAT(result.stats.nodesSettled++);
+
             if (currentNode == end)
             {
                 break;
@@ -163,41 +192,33 @@ public:
                 int nextNode = neighbor.first;
                 int edgeWeight = neighbor.second;
                 int newDist = currentDist + edgeWeight;
+                DSA_STAT(result.stats.edgesRelaxed++);
 
                 if (newDist < distances[nextNode])
                 {
                     distances[nextNode] = newDist;
                     parents[nextNode] = currentNode;
                     pq.push({newDist, nextNode});
+                    DSA_STAT(result.stats.heapPushes++);
                 }
             }
         }
 
-        if (distances[end] == INT_MAX)
+        result.distance = distances[end];
+        if (distances[end] != INT_MAX)
         {
-            cout << "No route found from " << start << " to " << end << ".\n";
-        }
-        else
-        {
-            cout << "Alternative route from " << start << " to " << end << " (distance: " << distances[end] << "):\n";
-            vector<int> route;
             for (int at = end; at != -1; at = parents[at])
             {
-                route.push_back(at);
+                result.route.push_back(at);
             }
-            reverse(route.begin(), route.end());
-
-            for (size_t i = 0; i < route.size(); ++i)
-            {
-                if (i > 0)
-                    cout << " -> ";
-                cout << route[i];
-            }
-            cout << endl;
+            reverse(result.route.begin(), result.route.end());
         }
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     Graph g;
@@ -221,13 +242,45 @@ int main()
     g.printAdjList();
 
     // Identify traffic bottlenecks
-    g.findTrafficBottlenecks();
+    BottleneckResult bottlenecks = g.findTrafficBottlenecks();
+    cout << "Traffic Bottlenecks (Edge Betweenness):\n";
+    for (const auto &entry : bottlenecks.edgeBetweenness)
+    {
+        cout << "Edge " << entry.first.first << " - " << entry.first.second << ": " << entry.second << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(bottlenecks.stats);
+#endif
 
     // Suggest traffic light timings
-    g.suggestTrafficLightTimings();
+    vector<int> greenSeconds = g.suggestTrafficLightTimings();
+    cout << "Traffic Light Timing Suggestions:\n";
+    for (size_t i = 0; i < greenSeconds.size(); ++i)
+    {
+        cout << "Node " << i << ": " << greenSeconds[i] << " seconds green time." << endl;
+    }
 
     // Find alternative routes
-    g.findAlternativeRoutes(0, 5);
+    RouteResult route = g.findAlternativeRoutes(0, 5);
+    if (route.route.empty())
+    {
+        cout << "No route found from 0 to 5.\n";
+    }
+    else
+    {
+        cout << "Alternative route from 0 to 5 (distance: " << route.distance << "):\n";
+        for (size_t i = 0; i < route.route.size(); ++i)
+        {
+            if (i > 0)
+                cout << " -> ";
+            cout << route.route[i];
+        }
+        cout << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(route.stats);
+#endif
     system("pause");
     return 0;
 }
+#endif
@@ -10,8 +10,1083 @@
 #include <iomanip>
 #include <cmath>
 #include <functional>
+#include <thread>
+#include <tuple>
+#include "dsa_stats.h"
 using namespace std;
 
+struct CriticalConnectionsResult
+{
+    vector<pair<int, int>> connections; // Bridges as (parent, child) in DFS order
+    SearchStats stats;
+};
+
+struct SpanningTreeResult
+{
+    vector<tuple<int, int, int>> links; // (parent, device, weight) for every device reached from device 0
+    vector<int> unreachable;            // Devices with no path from device 0, in id order
+    long long totalWeight = 0;
+    SearchStats stats;
+};
+
+// Resolve a requested worker count (0 = all hardware threads) against the amount of work
+int resolveThreadCount(int requested, size_t workItems)
+{
+    if (requested <= 0)
+    {
+        requested = max(1u, thread::hardware_concurrency());
+    }
+    return max(1, (int)min<size_t>(requested, max<size_t>(workItems, 1)));
+}
+
+// Run fn(index, threadId) for every index in [0, count) on numThreads workers
+template <typename Fn>
+void parallelFor(size_t count, int numThreads, Fn fn)
+{
+    auto worker = [&](int id)
+    {
+        for (size_t i = id; i < count; i += numThreads)
+        {
+            fn(i, id);
+        }
+    };
+
+    vector<thread> threads;
+    for (int id = 1; id < numThreads; ++id)
+    {
+        threads.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+// Max-flow / min-cut engine over an undirected capacitated topology
+class MaxFlowEngine
+{
+public:
+    enum class Algorithm
+    {
+        Dinic,
+        PushRelabel
+    };
+
+    struct Result
+    {
+        long long flow = 0;
+        vector<pair<int, int>> cutLinks; // Links crossing the minimum cut
+    };
+
+private:
+    int numNodes;
+    vector<tuple<int, int, int>> links; // Undirected links (u, v, capacity)
+    vector<int> firstArc;               // CSR offsets into the arc arrays
+    vector<int> arcHead;                // Target node of each arc
+    vector<int> arcReverse;             // Paired reverse arc
+    vector<long long> arcCapacity;      // Original capacity of each arc
+
+    // Per-query working state, one per thread for batched queries
+    struct Workspace
+    {
+        vector<long long> residual;
+        vector<int> level; // BFS level (Dinic) or height (push-relabel)
+        vector<int> currentArc;
+        vector<long long> excess;
+        vector<int> path;
+        vector<int> bfsQueue;
+        deque<int> active;
+        vector<char> inQueue;
+    };
+
+    void resetWorkspace(Workspace &ws) const
+    {
+        ws.residual = arcCapacity;
+        ws.level.assign(numNodes, -1);
+        ws.currentArc.assign(numNodes, 0);
+        ws.excess.assign(numNodes, 0);
+        ws.inQueue.assign(numNodes, 0);
+        ws.path.clear();
+        ws.active.clear();
+    }
+
+    // Build BFS levels from the source over residual arcs
+    bool buildLevels(Workspace &ws, int source, int sink) const
+    {
+        fill(ws.level.begin(), ws.level.end(), -1);
+        ws.bfsQueue.clear();
+        ws.bfsQueue.push_back(source);
+        ws.level[source] = 0;
+
+        for (size_t head = 0; head < ws.bfsQueue.size(); ++head)
+        {
+            int u = ws.bfsQueue[head];
+            for (int a = firstArc[u]; a < firstArc[u + 1]; ++a)
+            {
+                int v = arcHead[a];
+                if (ws.residual[a] > 0 && ws.level[v] < 0)
+                {
+                    ws.level[v] = ws.level[u] + 1;
+                    ws.bfsQueue.push_back(v);
+                }
+            }
+        }
+        return ws.level[sink] >= 0;
+    }
+
+    // Saturate a blocking flow in the level graph using current-arc pointers
+    long long blockingFlow(Workspace &ws, int source, int sink) const
+    {
+        long long total = 0;
+        copy(firstArc.begin(), firstArc.end() - 1, ws.currentArc.begin());
+        ws.path.clear();
+        int u = source;
+
+        while (true)
+        {
+            if (u == sink)
+            {
+                long long bottleneck = LLONG_MAX;
+                for (int a : ws.path)
+                {
+                    bottleneck = min(bottleneck, ws.residual[a]);
+                }
+                for (int a : ws.path)
+                {
+                    ws.residual[a] -= bottleneck;
+                    ws.residual[arcReverse[a]] += bottleneck;
+                }
+                total += bottleneck;
+                ws.path.clear();
+                u = source;
+                continue;
+            }
+
+            bool advanced = false;
+            for (int &a = ws.currentArc[u]; a < firstArc[u + 1]; ++a)
+            {
+                int v = arcHead[a];
+                if (ws.residual[a] > 0 && ws.level[v] == ws.level[u] + 1)
+                {
+                    ws.path.push_back(a);
+                    u = v;
+                    advanced = true;
+                    break;
+                }
+            }
+
+            if (!advanced)
+            {
+                if (u == source)
+                    break;
+
+                // Dead end: prune the node and retreat along the path
+                ws.level[u] = -1;
+                int a = ws.path.back();
+                ws.path.pop_back();
+                u = arcHead[arcReverse[a]];
+                ++ws.currentArc[u];
+            }
+        }
+        return total;
+    }
+
+    long long runDinic(Workspace &ws, int source, int sink) const
+    {
+        long long flow = 0;
+        while (buildLevels(ws, source, sink))
+        {
+            flow += blockingFlow(ws, source, sink);
+        }
+        return flow;
+    }
+
+    // Exact distance-to-sink labels by reverse BFS; unreachable nodes get numNodes
+    void globalRelabel(Workspace &ws, int source, int sink) const
+    {
+        fill(ws.level.begin(), ws.level.end(), numNodes);
+        ws.bfsQueue.clear();
+        ws.bfsQueue.push_back(sink);
+        ws.level[sink] = 0;
+
+        for (size_t head = 0; head < ws.bfsQueue.size(); ++head)
+        {
+            int u = ws.bfsQueue[head];
+            for (int a = firstArc[u]; a < firstArc[u + 1]; ++a)
+            {
+                int v = arcHead[a];
+                if (v != source && ws.level[v] == numNodes && ws.residual[arcReverse[a]] > 0)
+                {
+                    ws.level[v] = ws.level[u] + 1;
+                    ws.bfsQueue.push_back(v);
+                }
+            }
+        }
+        ws.level[source] = numNodes;
+        copy(firstArc.begin(), firstArc.end() - 1, ws.currentArc.begin());
+    }
+
+    void activate(Workspace &ws, int v, int source, int sink) const
+    {
+        if (v != source && v != sink && !ws.inQueue[v] && ws.level[v] < numNodes)
+        {
+            ws.inQueue[v] = 1;
+            ws.active.push_back(v);
+        }
+    }
+
+    // FIFO push-relabel (first phase only) with periodic global relabeling
+    long long runPushRelabel(Workspace &ws, int source, int sink) const
+    {
+        for (int a = firstArc[source]; a < firstArc[source + 1]; ++a)
+        {
+            long long delta = ws.residual[a];
+            if (delta > 0)
+            {
+                ws.residual[a] = 0;
+                ws.residual[arcReverse[a]] += delta;
+                ws.excess[arcHead[a]] += delta;
+                ws.excess[source] -= delta;
+            }
+        }
+
+        globalRelabel(ws, source, sink);
+        for (int v = 0; v < numNodes; ++v)
+        {
+            if (ws.excess[v] > 0)
+                activate(ws, v, source, sink);
+        }
+
+        int relabelsSinceGlobal = 0;
+        while (!ws.active.empty())
+        {
+            int u = ws.active.front();
+            ws.active.pop_front();
+            ws.inQueue[u] = 0;
+
+            while (ws.excess[u] > 0 && ws.level[u] < numNodes)
+            {
+                int &a = ws.currentArc[u];
+                if (a == firstArc[u + 1])
+                {
+                    // Relabel to one above the lowest residual neighbour
+                    int minLevel = numNodes;
+                    for (int b = firstArc[u]; b < firstArc[u + 1]; ++b)
+                    {
+                        if (ws.residual[b] > 0)
+                            minLevel = min(minLevel, ws.level[arcHead[b]] + 1);
+                    }
+                    ws.level[u] = minLevel;
+                    a = firstArc[u];
+                    ++relabelsSinceGlobal;
+                    continue;
+                }
+
+                int v = arcHead[a];
+                if (ws.residual[a] > 0 && ws.level[u] == ws.level[v] + 1)
+                {
+                    long long delta = min(ws.excess[u], ws.residual[a]);
+                    ws.residual[a] -= delta;
+                    ws.residual[arcReverse[a]] += delta;
+                    ws.excess[u] -= delta;
+                    ws.excess[v] += delta;
+                    activate(ws, v, source, sink);
+                    if (ws.residual[a] == 0)
+                        ++a;
+                }
+                else
+                {
+                    ++a;
+                }
+            }
+
+            if (relabelsSinceGlobal >= numNodes)
+            {
+                relabelsSinceGlobal = 0;
+                globalRelabel(ws, source, sink);
+                ws.active.clear();
+                fill(ws.inQueue.begin(), ws.inQueue.end(), 0);
+                for (int v = 0; v < numNodes; ++v)
+                {
+                    if (ws.excess[v] > 0)
+                        activate(ws, v, source, sink);
+                }
+            }
+        }
+        return ws.excess[sink];
+    }
+
+    Result solve(Workspace &ws, int source, int sink, Algorithm algorithm) const
+    {
+        Result result;
+        if (source < 0 || sink < 0 || source >= numNodes || sink >= numNodes || source == sink)
+        {
+            return result;
+        }
+
+        resetWorkspace(ws);
+        result.flow = algorithm == Algorithm::Dinic ? runDinic(ws, source, sink)
+                                                    : runPushRelabel(ws, source, sink);
+
+        // Nodes that can still reach the sink form the sink side of a minimum cut
+        globalRelabel(ws, source, sink);
+        for (const auto &link : links)
+        {
+            int u = get<0>(link);
+            int v = get<1>(link);
+            if ((ws.level[u] < numNodes) != (ws.level[v] < numNodes))
+            {
+                result.cutLinks.push_back({u, v});
+            }
+        }
+        return result;
+    }
+
+public:
+    MaxFlowEngine(int n, const vector<tuple<int, int, int>> &undirectedLinks)
+        : numNodes(n), links(undirectedLinks), firstArc(n + 1, 0)
+    {
+        for (const auto &link : links)
+        {
+            firstArc[get<0>(link) + 1]++;
+            firstArc[get<1>(link) + 1]++;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            firstArc[i + 1] += firstArc[i];
+        }
+
+        int numArcs = firstArc[n];
+        arcHead.resize(numArcs);
+        arcReverse.resize(numArcs);
+        arcCapacity.resize(numArcs);
+        vector<int> next(firstArc.begin(), firstArc.end() - 1);
+        for (const auto &link : links)
+        {
+            int u = get<0>(link);
+            int v = get<1>(link);
+            int forward = next[u]++;
+            int backward = next[v]++;
+            arcHead[forward] = v;
+            arcHead[backward] = u;
+            arcReverse[forward] = backward;
+            arcReverse[backward] = forward;
+            arcCapacity[forward] = arcCapacity[backward] = get<2>(link);
+        }
+    }
+
+    // Maximum flow and minimum cut between a single source/sink pair
+    Result maxFlow(int source, int sink, Algorithm algorithm = Algorithm::Dinic) const
+    {
+        Workspace ws;
+        return solve(ws, source, sink, algorithm);
+    }
+
+    // Solve many source/sink pairs in parallel, sharing the CSR topology
+    vector<Result> maxFlowBatch(const vector<pair<int, int>> &queries,
+                                Algorithm algorithm = Algorithm::Dinic, int numThreads = 0) const
+    {
+        vector<Result> results(queries.size());
+        numThreads = resolveThreadCount(numThreads, queries.size());
+        vector<Workspace> workspaces(numThreads);
+
+        parallelFor(queries.size(), numThreads, [&](size_t i, int id)
+                    { results[i] = solve(workspaces[id], queries[i].first, queries[i].second, algorithm); });
+        return results;
+    }
+};
+
+// All-pairs next-hop forwarding tables with incremental repair after link changes
+class RoutingTables
+{
+private:
+    struct Link
+    {
+        int u, v, weight;
+        bool up;
+    };
+
+    int numNodes;
+    int numThreads;
+    vector<Link> links;
+    vector<vector<pair<int, int>>> adj; // (neighbor, link id)
+
+    // Row-major per-source arrays, entry [source * numNodes + destination]
+    vector<int> dist;
+    vector<int> nextHop;    // -1 when the destination is unreachable
+    vector<int> parentLink; // Link entering the destination in the source's shortest-path tree
+
+    // Per-thread repair state; inSubtree is all zero between repairs
+    struct Workspace
+    {
+        vector<char> inSubtree;
+        vector<int> affected;
+    };
+    vector<Workspace> workspaces;
+
+    int otherEnd(int linkId, int node) const
+    {
+        return links[linkId].u == node ? links[linkId].v : links[linkId].u;
+    }
+
+    // Id of a link between u and v in the requested state, or -1
+    int findLink(int u, int v, bool up = true) const
+    {
+        if (u < 0 || u >= numNodes || v < 0 || v >= numNodes)
+            return -1;
+        for (const auto &neighbor : adj[u])
+        {
+            if (neighbor.first == v && links[neighbor.second].up == up)
+                return neighbor.second;
+        }
+        return -1;
+    }
+
+    // Dijkstra over queued entries of one source's row; returns the number of settled destinations
+    int settle(int source, priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> &pq)
+    {
+        int *d = &dist[(size_t)source * numNodes];
+        int *hop = &nextHop[(size_t)source * numNodes];
+        int *parent = &parentLink[(size_t)source * numNodes];
+        int settled = 0;
+
+        while (!pq.empty())
+        {
+            int currentDist = pq.top().first;
+            int node = pq.top().second;
+            pq.pop();
+
+            if (currentDist > d[node])
+                continue;
+
+            if (node != source)
+            {
+                int prev = otherEnd(parent[node], node);
+                hop[node] = prev == source ? node : hop[prev];
+            }
+            settled++;
+
+            for (const auto &neighbor : adj[node])
+            {
+                const Link &link = links[neighbor.second];
+                if (!link.up)
+                    continue;
+
+                int next = neighbor.first;
+                if (currentDist + link.weight < d[next])
+                {
+                    d[next] = currentDist + link.weight;
+                    parent[next] = neighbor.second;
+                    pq.push({d[next], next});
+                }
+            }
+        }
+        return settled;
+    }
+
+    void computeSource(int source)
+    {
+        size_t row = (size_t)source * numNodes;
+        fill(dist.begin() + row, dist.begin() + row + numNodes, INT_MAX);
+        fill(nextHop.begin() + row, nextHop.begin() + row + numNodes, -1);
+        fill(parentLink.begin() + row, parentLink.begin() + row + numNodes, -1);
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        dist[row + source] = 0;
+        nextHop[row + source] = source;
+        pq.push({0, source});
+        settle(source, pq);
+    }
+
+    // Repair one source after a link became longer or failed
+    int repairWorsened(Workspace &ws, int source, int linkId)
+    {
+        int *d = &dist[(size_t)source * numNodes];
+        int *hop = &nextHop[(size_t)source * numNodes];
+        int *parent = &parentLink[(size_t)source * numNodes];
+
+        int child = parent[links[linkId].u] == linkId ? links[linkId].u : links[linkId].v;
+        if (parent[child] != linkId)
+            return 0; // Not on any shortest path from this source
+
+        // Collect the subtree hanging below the changed link by following tree links downward
+        vector<int> &affected = ws.affected;
+        affected.assign(1, child);
+        ws.inSubtree[child] = 1;
+        for (size_t i = 0; i < affected.size(); ++i)
+        {
+            for (const auto &neighbor : adj[affected[i]])
+            {
+                int next = neighbor.first;
+                if (parent[next] == neighbor.second && !ws.inSubtree[next])
+                {
+                    ws.inSubtree[next] = 1;
+                    affected.push_back(next);
+                }
+            }
+        }
+        for (int node : affected)
+        {
+            d[node] = INT_MAX;
+            hop[node] = -1;
+            parent[node] = -1;
+        }
+
+        // Seed each affected destination from its best unaffected neighbour
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        for (int node : affected)
+        {
+            for (const auto &neighbor : adj[node])
+            {
+                const Link &link = links[neighbor.second];
+                int from = neighbor.first;
+                if (!link.up || ws.inSubtree[from] || d[from] == INT_MAX)
+                    continue;
+                if (d[from] + link.weight < d[node])
+                {
+                    d[node] = d[from] + link.weight;
+                    parent[node] = neighbor.second;
+                }
+            }
+            if (d[node] != INT_MAX)
+                pq.push({d[node], node});
+        }
+        settle(source, pq);
+
+        for (int node : affected)
+            ws.inSubtree[node] = 0;
+        return affected.size();
+    }
+
+    // Repair one source after a link became shorter or came back up
+    int repairImproved(int source, int linkId)
+    {
+        int *d = &dist[(size_t)source * numNodes];
+        int *parent = &parentLink[(size_t)source * numNodes];
+        const Link &link = links[linkId];
+
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+        if (d[link.u] != INT_MAX && d[link.u] + link.weight < d[link.v])
+        {
+            d[link.v] = d[link.u] + link.weight;
+            parent[link.v] = linkId;
+            pq.push({d[link.v], link.v});
+        }
+        if (d[link.v] != INT_MAX && d[link.v] + link.weight < d[link.u])
+        {
+            d[link.u] = d[link.v] + link.weight;
+            parent[link.u] = linkId;
+            pq.push({d[link.u], link.u});
+        }
+        return settle(source, pq);
+    }
+
+    // Sources whose shortest-path tree enters a destination through the link
+    vector<int> sourcesUsing(int linkId) const
+    {
+        vector<int> sources;
+        for (int source = 0; source < numNodes; ++source)
+        {
+            const int *parent = &parentLink[(size_t)source * numNodes];
+            if (parent[links[linkId].u] == linkId || parent[links[linkId].v] == linkId)
+                sources.push_back(source);
+        }
+        return sources;
+    }
+
+    // Sources for which the link now offers a shorter path to one of its ends
+    vector<int> sourcesImprovedBy(int linkId) const
+    {
+        const Link &link = links[linkId];
+        vector<int> sources;
+        for (int source = 0; source < numNodes; ++source)
+        {
+            const int *d = &dist[(size_t)source * numNodes];
+            if ((d[link.u] != INT_MAX && d[link.u] + link.weight < d[link.v]) ||
+                (d[link.v] != INT_MAX && d[link.v] + link.weight < d[link.u]))
+                sources.push_back(source);
+        }
+        return sources;
+    }
+
+    template <typename Repair>
+    long long repairAll(const vector<int> &sources, Repair repair)
+    {
+        int threads = resolveThreadCount(numThreads, sources.size());
+        vector<long long> perThread(threads, 0);
+        parallelFor(sources.size(), threads, [&](size_t i, int id)
+                    { perThread[id] += repair(workspaces[id], sources[i]); });
+
+        long long total = 0;
+        for (long long count : perThread)
+            total += count;
+        return total;
+    }
+
+public:
+    RoutingTables(int n, const vector<tuple<int, int, int>> &undirectedLinks, int threads = 0)
+        : numNodes(n), numThreads(resolveThreadCount(threads, n)), adj(n),
+          dist((size_t)n * n), nextHop((size_t)n * n), parentLink((size_t)n * n), workspaces(numThreads)
+    {
+        for (auto &ws : workspaces)
+            ws.inSubtree.assign(n, 0);
+        for (const auto &link : undirectedLinks)
+        {
+            int id = links.size();
+            links.push_back({get<0>(link), get<1>(link), get<2>(link), true});
+            adj[get<0>(link)].push_back({get<1>(link), id});
+            adj[get<1>(link)].push_back({get<0>(link), id});
+        }
+
+        parallelFor(numNodes, numThreads, [&](size_t source, int)
+                    { computeSource((int)source); });
+    }
+
+    int getNextHop(int source, int destination) const
+    {
+        return nextHop[(size_t)source * numNodes + destination];
+    }
+
+    int getDistance(int source, int destination) const
+    {
+        return dist[(size_t)source * numNodes + destination];
+    }
+
+    // Take a link down; returns the number of recomputed table entries, or -1 if no such link
+    long long failLink(int u, int v)
+    {
+        int id = findLink(u, v);
+        if (id < 0)
+            return -1;
+
+        links[id].up = false;
+        return repairAll(sourcesUsing(id), [&](Workspace &ws, int source)
+                         { return repairWorsened(ws, source, id); });
+    }
+
+    // Bring a failed link back up with the given weight; returns the number of recomputed table
+    // entries, or -1 if there is no failed link between u and v
+    long long restoreLink(int u, int v, int weight)
+    {
+        int id = findLink(u, v, false);
+        if (id < 0)
+            return -1;
+
+        links[id].up = true;
+        links[id].weight = weight;
+        return repairAll(sourcesImprovedBy(id), [&](Workspace &, int source)
+                         { return repairImproved(source, id); });
+    }
+
+    // Change a link's weight; returns the number of recomputed table entries, or -1 if no such link
+    long long updateLinkWeight(int u, int v, int weight)
+    {
+        int id = findLink(u, v);
+        if (id < 0)
+            return -1;
+
+        int oldWeight = links[id].weight;
+        links[id].weight = weight;
+        if (weight > oldWeight)
+        {
+            return repairAll(sourcesUsing(id), [&](Workspace &ws, int source)
+                             { return repairWorsened(ws, source, id); });
+        }
+        if (weight < oldWeight)
+        {
+            return repairAll(sourcesImprovedBy(id), [&](Workspace &, int source)
+                             { return repairImproved(source, id); });
+        }
+        return 0;
+    }
+
+    // Print the forwarding table of one device
+    void printTable(int device) const
+    {
+        cout << "Routing table for device " << device << ":\n";
+        for (int dest = 0; dest < numNodes; ++dest)
+        {
+            if (dest == device)
+                continue;
+
+            int hop = getNextHop(device, dest);
+            if (hop < 0)
+            {
+                cout << "To " << dest << ": unreachable\n";
+            }
+            else
+            {
+                cout << "To " << dest << ": via " << hop << " (cost " << getDistance(device, dest) << ")\n";
+            }
+        }
+    }
+};
+
+// Batch what-if evaluation of link/device failures against a precomputed spanning forest
+class FailureSimulator
+{
+public:
+    struct Scenario
+    {
+        vector<pair<int, int>> failedLinks; // Every link between the two devices goes down
+        vector<int> failedDevices;
+    };
+
+    struct Result
+    {
+        long long spanningCost = 0;        // Minimum spanning forest cost after the failures
+        long long costIncrease = 0;        // Relative to the intact network
+        vector<int> partitionedDevices;    // Live devices cut off from the largest part of their component
+    };
+
+private:
+    struct Edge
+    {
+        int u, v, weight;
+    };
+
+    int numNodes;
+    long long baseCost = 0;
+
+    // Spanning forest laid out in DFS order: subtree of x is order[tin[x] .. tout[x]]
+    vector<int> parent;
+    vector<int> parentWeight;
+    vector<int> treeRoot;
+    vector<int> tin, tout;
+    vector<int> order;
+    vector<int> firstChild; // CSR offsets into children
+    vector<int> children;
+    vector<char> bridgeToParent; // Tree edge (parent[x], x) is a bridge
+
+    // Non-tree edges grouped by tree root and sorted by weight
+    vector<Edge> nonTreeEdges;
+    vector<int> nonTreeBegin, nonTreeEnd; // Indexed by tree root
+
+    static int findSet(vector<int> &dsu, int x)
+    {
+        while (dsu[x] != x)
+        {
+            dsu[x] = dsu[dsu[x]];
+            x = dsu[x];
+        }
+        return x;
+    }
+
+    Result evaluate(const Scenario &scenario) const
+    {
+        Result result;
+        result.spanningCost = baseCost;
+
+        vector<pair<int, int>> failedLinks;
+        for (const auto &link : scenario.failedLinks)
+        {
+            failedLinks.push_back({min(link.first, link.second), max(link.first, link.second)});
+        }
+        sort(failedLinks.begin(), failedLinks.end());
+        vector<int> failedDevices;
+        for (int d : scenario.failedDevices)
+        {
+            if (d >= 0 && d < numNodes)
+                failedDevices.push_back(d);
+        }
+        sort(failedDevices.begin(), failedDevices.end());
+        failedDevices.erase(unique(failedDevices.begin(), failedDevices.end()), failedDevices.end());
+
+        auto deviceFailed = [&](int d)
+        { return binary_search(failedDevices.begin(), failedDevices.end(), d); };
+        auto linkFailed = [&](int u, int v)
+        {
+            return deviceFailed(u) || deviceFailed(v) ||
+                   binary_search(failedLinks.begin(), failedLinks.end(), make_pair(min(u, v), max(u, v)));
+        };
+
+        // Tree edges removed by the scenario, named by their child endpoint
+        vector<int> heads;
+        for (const auto &link : failedLinks)
+        {
+            int u = link.first, v = link.second;
+            if (u < 0 || v >= numNodes)
+                continue;
+            if (parent[v] == u)
+                heads.push_back(v);
+            else if (parent[u] == v)
+                heads.push_back(u);
+        }
+        for (int d : failedDevices)
+        {
+            if (parent[d] >= 0)
+                heads.push_back(d);
+            for (int c = firstChild[d]; c < firstChild[d + 1]; ++c)
+                heads.push_back(children[c]);
+        }
+        sort(heads.begin(), heads.end());
+        heads.erase(unique(heads.begin(), heads.end()), heads.end());
+
+        if (heads.empty() && failedDevices.empty())
+            return result; // Only non-tree links failed: nothing changes
+
+        vector<int> touchedRoots;
+        for (int h : heads)
+        {
+            result.spanningCost -= parentWeight[h];
+            touchedRoots.push_back(treeRoot[h]);
+        }
+        for (int d : failedDevices)
+            touchedRoots.push_back(treeRoot[d]);
+        sort(touchedRoots.begin(), touchedRoots.end());
+        touchedRoots.erase(unique(touchedRoots.begin(), touchedRoots.end()), touchedRoots.end());
+
+        // Pieces of the broken forest, each headed by a cut child or a tree root
+        heads.insert(heads.end(), touchedRoots.begin(), touchedRoots.end());
+        sort(heads.begin(), heads.end(), [&](int a, int b)
+             { return tin[a] < tin[b]; });
+        heads.erase(unique(heads.begin(), heads.end()), heads.end());
+
+        int numPieces = heads.size();
+        vector<int> enclosing(numPieces, -1);
+        vector<int> pieceSize(numPieces);
+        vector<int> stackOfPieces;
+        for (int i = 0; i < numPieces; ++i)
+        {
+            while (!stackOfPieces.empty() && tout[heads[stackOfPieces.back()]] < tin[heads[i]])
+                stackOfPieces.pop_back();
+            pieceSize[i] = tout[heads[i]] - tin[heads[i]] + 1;
+            if (!stackOfPieces.empty())
+            {
+                enclosing[i] = stackOfPieces.back();
+                pieceSize[enclosing[i]] -= pieceSize[i];
+            }
+            stackOfPieces.push_back(i);
+        }
+
+        auto pieceOf = [&](int x)
+        {
+            int i = int(upper_bound(heads.begin(), heads.end(), x, [&](int node, int h)
+                                    { return tin[node] < tin[h]; }) -
+                         heads.begin()) - 1;
+            while (tout[heads[i]] < tin[x])
+                i = enclosing[i];
+            return i;
+        };
+
+        // Reconnect pieces with the cheapest surviving non-tree edges of each touched tree
+        vector<int> dsu(numPieces);
+        for (int i = 0; i < numPieces; ++i)
+            dsu[i] = i;
+
+        for (int root : touchedRoots)
+        {
+            int livePieces = 0;
+            bool onlyBridges = true;
+            for (int i = 0; i < numPieces; ++i)
+            {
+                if (treeRoot[heads[i]] != root)
+                    continue;
+                if (deviceFailed(heads[i]))
+                    onlyBridges = false;
+                else
+                    livePieces++;
+                if (heads[i] != root && !bridgeToParent[heads[i]])
+                    onlyBridges = false;
+            }
+
+            // Removing only bridges leaves nothing that could bridge the pieces again
+            if (onlyBridges)
+                continue;
+
+            int merges = 0;
+            for (int e = nonTreeBegin[root]; e < nonTreeEnd[root] && merges < livePieces - 1; ++e)
+            {
+                const Edge &edge = nonTreeEdges[e];
+                if (linkFailed(edge.u, edge.v))
+                    continue;
+
+                int a = findSet(dsu, pieceOf(edge.u));
+                int b = findSet(dsu, pieceOf(edge.v));
+                if (a != b)
+                {
+                    dsu[a] = b;
+                    result.spanningCost += edge.weight;
+                    merges++;
+                }
+            }
+        }
+        result.costIncrease = result.spanningCost - baseCost;
+
+        // Everything outside the largest surviving group of each tree is partitioned
+        vector<int> groupSize(numPieces, 0);
+        for (int i = 0; i < numPieces; ++i)
+        {
+            if (!deviceFailed(heads[i]))
+                groupSize[findSet(dsu, i)] += pieceSize[i];
+        }
+        vector<int> keep(numPieces, -1); // Largest group per tree, indexed by the tree's root piece
+        for (int i = 0; i < numPieces; ++i)
+        {
+            int g = findSet(dsu, i);
+            int rootPiece = pieceOf(treeRoot[heads[i]]);
+            if (groupSize[g] > 0 && (keep[rootPiece] < 0 || groupSize[g] > groupSize[keep[rootPiece]]))
+                keep[rootPiece] = g;
+        }
+        for (int i = 0; i < numPieces; ++i)
+        {
+            int h = heads[i];
+            if (deviceFailed(h) || findSet(dsu, i) == keep[pieceOf(treeRoot[h])])
+                continue;
+
+            // Walk the piece's DFS range, skipping nested pieces
+            int j = i + 1;
+            for (int pos = tin[h]; pos <= tout[h]; ++pos)
+            {
+                while (j < numPieces && tin[heads[j]] < pos)
+                    j++;
+                if (j < numPieces && tin[heads[j]] == pos)
+                {
+                    pos = tout[heads[j]];
+                    j++;
+                    continue;
+                }
+                result.partitionedDevices.push_back(order[pos]);
+            }
+        }
+        sort(result.partitionedDevices.begin(), result.partitionedDevices.end());
+        return result;
+    }
+
+public:
+    FailureSimulator(int n, const vector<tuple<int, int, int>> &undirectedLinks)
+        : numNodes(n), parent(n, -1), parentWeight(n, 0), treeRoot(n), tin(n), tout(n), order(n),
+          firstChild(n + 1, 0), bridgeToParent(n, 0), nonTreeBegin(n, 0), nonTreeEnd(n, 0)
+    {
+        // Minimum spanning forest (Kruskal)
+        vector<Edge> edges;
+        for (const auto &link : undirectedLinks)
+        {
+            edges.push_back({get<0>(link), get<1>(link), get<2>(link)});
+        }
+        sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b)
+             { return a.weight < b.weight; });
+
+        vector<int> dsu(n);
+        for (int i = 0; i < n; ++i)
+            dsu[i] = i;
+        vector<vector<pair<int, int>>> treeAdj(n);
+        vector<Edge> remaining;
+        for (const Edge &edge : edges)
+        {
+            int a = findSet(dsu, edge.u);
+            int b = findSet(dsu, edge.v);
+            if (a != b)
+            {
+                dsu[a] = b;
+                baseCost += edge.weight;
+                treeAdj[edge.u].push_back({edge.v, edge.weight});
+                treeAdj[edge.v].push_back({edge.u, edge.weight});
+            }
+            else
+            {
+                remaining.push_back(edge);
+            }
+        }
+
+        // Iterative DFS numbering of every tree
+        int timer = 0;
+        vector<char> visited(n, 0);
+        vector<pair<int, size_t>> stackOfNodes;
+        for (int r = 0; r < n; ++r)
+        {
+            if (visited[r])
+                continue;
+            visited[r] = 1;
+            treeRoot[r] = r;
+            order[timer] = r;
+            tin[r] = timer++;
+            stackOfNodes.push_back({r, 0});
+            while (!stackOfNodes.empty())
+            {
+                int u = stackOfNodes.back().first;
+                size_t &next = stackOfNodes.back().second;
+                if (next == treeAdj[u].size())
+                {
+                    tout[u] = timer - 1;
+                    stackOfNodes.pop_back();
+                    continue;
+                }
+
+                auto neighbor = treeAdj[u][next++];
+                int v = neighbor.first;
+                if (visited[v])
+                    continue;
+                visited[v] = 1;
+                parent[v] = u;
+                parentWeight[v] = neighbor.second;
+                treeRoot[v] = r;
+                order[timer] = v;
+                tin[v] = timer++;
+                stackOfNodes.push_back({v, 0});
+            }
+        }
+
+        // Children of every node, in DFS order
+        for (int v = 0; v < n; ++v)
+        {
+            if (parent[v] >= 0)
+                firstChild[parent[v] + 1]++;
+        }
+        for (int i = 0; i < n; ++i)
+            firstChild[i + 1] += firstChild[i];
+        children.resize(firstChild[n]);
+        vector<int> fillPos(firstChild.begin(), firstChild.end() - 1);
+        for (int pos = 0; pos < n; ++pos)
+        {
+            int v = order[pos];
+            if (parent[v] >= 0)
+                children[fillPos[parent[v]]++] = v;
+        }
+
+        // Bridge index: a tree edge is a bridge when no non-tree edge leaves the child's subtree
+        vector<int> lowTin(tin), highTin(tin);
+        for (const Edge &edge : remaining)
+        {
+            lowTin[edge.u] = min(lowTin[edge.u], tin[edge.v]);
+            highTin[edge.u] = max(highTin[edge.u], tin[edge.v]);
+            lowTin[edge.v] = min(lowTin[edge.v], tin[edge.u]);
+            highTin[edge.v] = max(highTin[edge.v], tin[edge.u]);
+        }
+        for (int pos = n - 1; pos >= 0; --pos)
+        {
+            int v = order[pos];
+            if (parent[v] < 0)
+                continue;
+            bridgeToParent[v] = lowTin[v] >= tin[v] && highTin[v] <= tout[v];
+            lowTin[parent[v]] = min(lowTin[parent[v]], lowTin[v]);
+            highTin[parent[v]] = max(highTin[parent[v]], highTin[v]);
+        }
+
+        // Group non-tree edges by tree, keeping weight order within each group
+        stable_sort(remaining.begin(), remaining.end(), [&](const Edge &a, const Edge &b)
+                    { return treeRoot[a.u] < treeRoot[b.u]; });
+        nonTreeEdges = move(remaining);
+        for (int e = 0; e < (int)nonTreeEdges.size(); ++e)
+        {
+            int root = treeRoot[nonTreeEdges[e].u];
+            if (nonTreeEnd[root] == 0)
+                nonTreeBegin[root] = e;
+            nonTreeEnd[root] = e + 1;
+        }
+    }
+
+    // Evaluate every scenario in parallel
+    vector<Result> simulate(const vector<Scenario> &scenarios, int numThreads = 0) const
+    {
+        vector<Result> results(scenarios.size());
+        parallelFor(scenarios.size(), resolveThreadCount(numThreads, scenarios.size()), [&](size_t i, int)
+                    { results[i] = evaluate(scenarios[i]); });
+        return results;
+    }
+};
+
 class NetworkGraph
 {
 private:
@@ -55,22 +1130,26 @@ public:
     }
 
     // Find critical connections (bridges) in the network
-    void findCriticalConnections()
+    CriticalConnectionsResult findCriticalConnections()
     {
+        CriticalConnectionsResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         vector<int> discovery(numDevices, -1);
         vector<int> low(numDevices, -1);
         vector<bool> visited(numDevices, false);
         int timer = 0;
-        vector<pair<int, int>> criticalConnections;
+        vector<pair<int, int>> &criticalConnections = result.connections;
 
         function<void(int, int)> dfs = [&](int u, int parent)
         {
             visited[u] = true;
             discovery[u] = low[u] = timer++;
+            DSA_STAT(result.stats.nodesSettled++);
 
             for (const auto &neighbor : adjList[u])
             {
                 int v = neighbor.first;
+                DSA_STAT(result.stats.edgesRelaxed++);
                 if (v == parent)
                     continue;
 
@@ -96,19 +1175,19 @@ public:
             if (!visited[i])
             {
                 dfs(i, -1);
+                DSA_STAT(result.stats.iterations++);
             }
         }
 
-        cout << "Critical Connections in the Network:\n";
-        for (const auto &connection : criticalConnections)
-        {
-            cout << "Connection " << connection.first << " - " << connection.second << endl;
-        }
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 
     // Optimize network topology using Minimum Spanning Tree (Prim's Algorithm)
-    void optimizeTopology()
+    SpanningTreeResult optimizeTopology()
     {
+        SpanningTreeResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
         vector<bool> inMST(numDevices, false);
         vector<int> key(numDevices, INT_MAX);
@@ -116,36 +1195,101 @@ public:
 
         key[0] = 0;
         pq.push({0, 0});
+        DSA_STAT(result.stats.heapPushes++);
 
         while (!pq.empty())
         {
             int u = pq.top().second;
             pq.pop();
 
+            // A device already in the tree was popped earlier with a smaller key
+            if (inMST[u])
+            {
+                DSA_STAT(result.stats.stalePops++);
+                continue;
+            }
             inMST[u] = true;
+            DSA_STAT(result.stats.nodesSettled++);
 
             for (const auto &neighbor : adjList[u])
             {
                 int v = neighbor.first;
                 int weight = neighbor.second;
+                DSA_STAT(result.stats.edgesRelaxed++);
 
                 if (!inMST[v] && weight < key[v])
                 {
                     key[v] = weight;
                     pq.push({key[v], v});
+                    DSA_STAT(result.stats.heapPushes++);
                     parent[v] = u;
                 }
             }
         }
 
-        cout << "Optimized Network Topology (MST):\n";
         for (int i = 1; i < numDevices; ++i)
         {
-            cout << "Connection " << parent[i] << " - " << i << " with weight " << key[i] << endl;
+            if (parent[i] == -1)
+            {
+                result.unreachable.push_back(i);
+                continue;
+            }
+            result.links.emplace_back(parent[i], i, key[i]);
+            result.totalWeight += key[i];
+        }
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
+    }
+    // Collect each undirected link once as (u, v, weight)
+    vector<tuple<int, int, int>> getLinks() const
+    {
+        vector<tuple<int, int, int>> links;
+        for (int u = 0; u < numDevices; ++u)
+        {
+            auto it = adjList.find(u);
+            if (it == adjList.end())
+                continue;
+            for (const auto &neighbor : it->second)
+            {
+                if (u < neighbor.first)
+                {
+                    links.emplace_back(u, neighbor.first, neighbor.second);
+                }
+            }
+        }
+        return links;
+    }
+
+    // Build a max-flow engine treating link weights as capacities
+    MaxFlowEngine buildFlowEngine() const
+    {
+        return MaxFlowEngine(numDevices, getLinks());
+    }
+
+    // Build shortest-path next-hop tables for every device
+    RoutingTables buildRoutingTables(int numThreads = 0) const
+    {
+        return RoutingTables(numDevices, getLinks(), numThreads);
+    }
+
+    // Precompute the spanning forest and bridge index for what-if failure analysis
+    FailureSimulator buildFailureSimulator() const
+    {
+        return FailureSimulator(numDevices, getLinks());
+    }
+
+    // Report the bottleneck capacity and min-cut links between two devices
+    MaxFlowEngine::Result analyzeCapacity(int source, int sink, MaxFlowEngine::Algorithm algorithm = MaxFlowEngine::Algorithm::Dinic)
+    {
+        if (source < 0 || sink < 0 || source >= numDevices || sink >= numDevices || source == sink)
+        {
+            return MaxFlowEngine::Result();
         }
+        return buildFlowEngine().maxFlow(source, sink, algorithm);
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     NetworkGraph network;
@@ -168,10 +1312,71 @@ int main()
     network.printTopology();
 
     // Find critical connections
-    network.findCriticalConnections();
+    CriticalConnectionsResult bridges = network.findCriticalConnections();
+    cout << "Critical Connections in the Network:\n";
+    for (const auto &connection : bridges.connections)
+    {
+        cout << "Connection " << connection.first << " - " << connection.second << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(bridges.stats);
+#endif
 
     // Optimize network topology
-    network.optimizeTopology();
+    SpanningTreeResult tree = network.optimizeTopology();
+    cout << "Optimized Network Topology (MST):\n";
+    for (const auto &link : tree.links)
+    {
+        cout << "Connection " << get<0>(link) << " - " << get<1>(link) << " with weight " << get<2>(link) << endl;
+    }
+    for (int device : tree.unreachable)
+    {
+        cout << "Device " << device << " is unreachable from device 0\n";
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(tree.stats);
+#endif
+
+    // Analyze bottleneck capacity between devices
+    vector<tuple<int, int, MaxFlowEngine::Algorithm>> capacityQueries = {
+        {0, 5, MaxFlowEngine::Algorithm::Dinic},
+        {0, 3, MaxFlowEngine::Algorithm::PushRelabel}};
+    for (const auto &query : capacityQueries)
+    {
+        MaxFlowEngine::Result capacity = network.analyzeCapacity(get<0>(query), get<1>(query), get<2>(query));
+        cout << "Maximum capacity from " << get<0>(query) << " to " << get<1>(query) << ": " << capacity.flow << endl;
+        cout << "Minimum cut links:\n";
+        for (const auto &link : capacity.cutLinks)
+        {
+            cout << "Connection " << link.first << " - " << link.second << endl;
+        }
+    }
+
+    // Build routing tables and repair them after a link failure
+    RoutingTables routes = network.buildRoutingTables();
+    routes.printTable(0);
+    cout << "Entries recomputed after link 1 - 2 failed: " << routes.failLink(1, 2) << endl;
+    routes.printTable(0);
+    cout << "Entries recomputed after link 1 - 2 came back up: " << routes.restoreLink(1, 2, 1) << endl;
+    routes.printTable(0);
+
+    // Evaluate candidate maintenance failures
+    FailureSimulator simulator = network.buildFailureSimulator();
+    vector<FailureSimulator::Scenario> scenarios = {
+        {{{1, 2}}, {}},
+        {{{0, 2}, {1, 2}}, {}},
+        {{}, {3}}};
+    vector<FailureSimulator::Result> outcomes = simulator.simulate(scenarios);
+    for (size_t i = 0; i < outcomes.size(); ++i)
+    {
+        cout << "Scenario " << i << ": spanning cost change " << outcomes[i].costIncrease << ", partitioned devices: ";
+        for (int device : outcomes[i].partitionedDevices)
+        {
+            cout << device << " ";
+        }
+        cout << endl;
+    }
     system("pause");
     return 0;
 }
+#endif
@@ -0,0 +1,34 @@
+// Per-call search counters shared by the lab programs. They are recorded only when
+// compiled with -DDSA_LAB_INSTRUMENT; otherwise DSA_STAT(...) expands to nothing and
+// every counter stays zero.
+#pragma once
+
+#include <chrono>
+#include <iostream>
+
+struct SearchStats
+{
+    long long nodesSettled = 0;
+    long long edgesRelaxed = 0;
+    long long heapPushes = 0;
+    long long stalePops = 0;
+    long long iterations = 0;
+    double wallMs = 0;
+};
+
+#ifdef DSA_LAB_INSTRUMENT
+#define DSA_STAT(statement) statement
+inline double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+#else
+#define DSA_STAT(statement)
+#endif
+
+inline void printSearchStats(const SearchStats &stats)
+{
+    std::cout << "  [settled " << stats.nodesSettled << ", relaxed " << stats.edgesRelaxed << ", pushes "
+              << stats.heapPushes << ", stale pops " << stats.stalePops << ", iterations " << stats.iterations << ", "
+              << stats.wallMs << " ms]\n";
+}
@@ -9,8 +9,28 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include "dsa_stats.h"
 using namespace std;
 
+struct PathResult
+{
+    vector<int> path; // Empty when the goal is unreachable
+    int cost = INT_MAX;
+    SearchStats stats;
+};
+
+struct DistanceResult
+{
+    vector<int> distances; // INT_MAX for unreachable vertices
+    SearchStats stats;
+};
+
+struct PageRankResult
+{
+    vector<double> rank;
+    SearchStats stats;
+};
+
 class Graph
 {
 private:
@@ -53,21 +73,33 @@ public:
     }
 
     // A* algorithm for route planning
-    void aStar(int start, int goal, const vector<int> &heuristic)
+    PathResult aStar(int start, int goal, const vector<int> &heuristic)
     {
+        PathResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         vector<int> distances(numVertices, INT_MAX);
         distances[start] = 0;
 
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
         pq.push({heuristic[start], start});
+        DSA_STAT(result.stats.heapPushes++);
 
         vector<int> parents(numVertices, -1);
 
         while (!pq.empty())
         {
+            int currentPriority = pq.top().first;
             int currentNode = pq.top().second;
             pq.pop();
 
+            // Skip entries superseded by a cheaper path found after they were pushed
+            if (currentPriority > distances[currentNode] + heuristic[currentNode])
+            {
+                DSA_STAT(result.stats.stalePops++);
+                continue;
+            }
+            DSA_STAT(result.stats.nodesSettled++);
+
             if (currentNode == goal)
             {
                 break;
@@ -78,49 +110,43 @@ public:
                 int nextNode = neighbor.first;
                 int edgeWeight = neighbor.second;
                 int newCost = distances[currentNode] + edgeWeight;
+                DSA_STAT(result.stats.edgesRelaxed++);
 
                 if (newCost < distances[nextNode])
                 {
                     distances[nextNode] = newCost;
                     parents[nextNode] = currentNode;
                     pq.push({newCost + heuristic[nextNode], nextNode});
+                    DSA_STAT(result.stats.heapPushes++);
                 }
             }
         }
 
-        // Print the path and distance
-        if (distances[goal] == INT_MAX)
-        {
-            cout << "No path found from " << start << " to " << goal << ".\n";
-        }
-        else
+        result.cost = distances[goal];
+        if (distances[goal] != INT_MAX)
         {
-            cout << "Shortest path from " << start << " to " << goal << " is: ";
-            vector<int> path;
             for (int at = goal; at != -1; at = parents[at])
             {
-                path.push_back(at);
+                result.path.push_back(at);
             }
-            reverse(path.begin(), path.end());
-
-            for (size_t i = 0; i < path.size(); ++i)
-            {
-                if (i > 0)
-                    cout << " -> ";
-                cout << path[i];
-            }
-            cout << "\nTotal cost: " << distances[goal] << endl;
+            reverse(result.path.begin(), result.path.end());
         }
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 
     // Dijkstra's algorithm using priority queue
-    void dijkstra(int start)
+    DistanceResult dijkstra(int start)
     {
-        vector<int> distances(numVertices, INT_MAX);
+        DistanceResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
+        vector<int> &distances = result.distances;
+        distances.assign(numVertices, INT_MAX);
         distances[start] = 0;
 
         priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
         pq.push({0, start});
+        DSA_STAT(result.stats.heapPushes++);
 
         while (!pq.empty())
         {
@@ -130,39 +156,35 @@ public:
 
             if (currentDist > distances[currentNode])
             {
+                DSA_STAT(result.stats.stalePops++);
                 continue;
             }
+            DSA_STAT(result.stats.nodesSettled++);
 
             for (const auto &neighbor : adjList[currentNode])
             {
                 int nextNode = neighbor.first;
                 int edgeWeight = neighbor.second;
+                DSA_STAT(result.stats.edgesRelaxed++);
 
                 if (distances[currentNode] + edgeWeight < distances[nextNode])
                 {
                     distances[nextNode] = distances[currentNode] + edgeWeight;
                     pq.push({distances[nextNode], nextNode});
+                    DSA_STAT(result.stats.heapPushes++);
                 }
             }
         }
 
-        cout << "Shortest distances from vertex " << start << ":\n";
-        for (int i = 0; i < numVertices; ++i)
-        {
-            if (distances[i] == INT_MAX)
-            {
-                cout << i << ": INF\n";
-            }
-            else
-            {
-                cout << i << ": " << distances[i] << "\n";
-            }
-        }
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 
     // PageRank algorithm
-    void pageRank(double dampingFactor = 0.85, int iterations = 100)
+    PageRankResult pageRank(double dampingFactor = 0.85, int iterations = 100)
     {
+        PageRankResult result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         vector<double> rank(numVertices, 1.0 / numVertices);
         vector<double> newRank(numVertices, 0.0);
 
@@ -180,6 +202,7 @@ public:
                     {
                         newRank[neighbor.first] += distribute;
                     }
+                    DSA_STAT(result.stats.edgesRelaxed += outDegree);
                 }
                 else
                 {
@@ -192,17 +215,16 @@ public:
             }
 
             rank = newRank;
+            DSA_STAT(result.stats.iterations++);
         }
 
-        cout << fixed << setprecision(6);
-        cout << "PageRank Values:\n";
-        for (int i = 0; i < numVertices; ++i)
-        {
-            cout << "Vertex " << i << ": " << rank[i] << endl;
-        }
+        result.rank = move(rank);
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     Graph g;
@@ -225,13 +247,56 @@ int main()
 
     // Perform A* algorithm for route planning
     vector<int> heuristic = {7, 6, 2, 0}; // Example heuristic values
-    g.aStar(0, 3, heuristic);
+    PathResult route = g.aStar(0, 3, heuristic);
+    if (route.path.empty())
+    {
+        cout << "No path found from 0 to 3.\n";
+    }
+    else
+    {
+        cout << "Shortest path from 0 to 3 is: ";
+        for (size_t i = 0; i < route.path.size(); ++i)
+        {
+            if (i > 0)
+                cout << " -> ";
+            cout << route.path[i];
+        }
+        cout << "\nTotal cost: " << route.cost << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(route.stats);
+#endif
 
     // Perform Dijkstra's algorithm
-    g.dijkstra(0);
+    DistanceResult shortest = g.dijkstra(0);
+    cout << "Shortest distances from vertex 0:\n";
+    for (size_t i = 0; i < shortest.distances.size(); ++i)
+    {
+        if (shortest.distances[i] == INT_MAX)
+        {
+            cout << i << ": INF\n";
+        }
+        else
+        {
+            cout << i << ": " << shortest.distances[i] << "\n";
+        }
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(shortest.stats);
+#endif
 
     // Perform PageRank
-    g.pageRank();
+    PageRankResult ranks = g.pageRank();
+    cout << fixed << setprecision(6);
+    cout << "PageRank Values:\n";
+    for (size_t i = 0; i < ranks.rank.size(); ++i)
+    {
+        cout << "Vertex " << i << ": " << ranks.rank[i] << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(ranks.stats);
+#endif
     system("pause");
     return 0;
 }
+#endif
@@ -9,14 +9,1739 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "dsa_stats.h"
 using namespace std;
 
+struct CommunityList
+{
+    vector<vector<int>> communities; // Members of each connected community in BFS order
+    SearchStats stats;
+};
+
+// Resolve a requested worker count (0 = all hardware threads)
+int resolveThreadCount(int requested)
+{
+    return requested > 0 ? requested : max(1u, thread::hardware_concurrency());
+}
+
+// Run fn(index, threadId) for every index in [0, count), handing out blocks dynamically
+template <typename Fn>
+void parallelFor(size_t count, int numThreads, Fn fn, size_t blockSize = 1024)
+{
+    numThreads = (int)max<size_t>(1, min<size_t>(numThreads, (count + blockSize - 1) / blockSize));
+    atomic<size_t> nextBlock(0);
+    auto worker = [&](int id)
+    {
+        for (size_t begin = nextBlock.fetch_add(blockSize); begin < count; begin = nextBlock.fetch_add(blockSize))
+        {
+            size_t end = min(count, begin + blockSize);
+            for (size_t i = begin; i < end; ++i)
+            {
+                fn(i, id);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int id = 1; id < numThreads; ++id)
+    {
+        threads.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+// Run fn(begin, end, threadId) on numThreads equal contiguous slices of [0, count)
+template <typename Fn>
+void parallelRanges(size_t count, int numThreads, Fn fn)
+{
+    vector<thread> threads;
+    for (int id = 1; id < numThreads; ++id)
+    {
+        threads.emplace_back(fn, count * id / numThreads, count * (id + 1) / numThreads, id);
+    }
+    fn(0, count / numThreads, 0);
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+// Read-only compressed sparse row snapshot of an undirected graph
+struct CSRGraph
+{
+    int numVertices = 0;
+    vector<size_t> offsets; // Neighbors of v are neighbors[offsets[v] .. offsets[v + 1])
+    vector<int> neighbors;
+
+    size_t degree(int v) const
+    {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    size_t numEdges() const
+    {
+        return neighbors.size();
+    }
+
+    // Call fn(neighbor) for each neighbor of v until fn returns false
+    template <typename Fn>
+    void forEachNeighbor(int v, Fn fn) const
+    {
+        for (size_t e = offsets[v]; e < offsets[v + 1]; ++e)
+        {
+            if (!fn(neighbors[e]))
+                return;
+        }
+    }
+
+    size_t memoryBytes() const
+    {
+        return offsets.size() * sizeof(size_t) + neighbors.size() * sizeof(int);
+    }
+};
+
+// Shuffle masks and byte lengths for decoding one stream-vbyte control byte (four values)
+struct StreamVByteTables
+{
+    uint8_t shuffle[256][16];
+    uint8_t length[256];
+
+    StreamVByteTables()
+    {
+        for (int control = 0; control < 256; ++control)
+        {
+            int source = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                int bytes = ((control >> (2 * i)) & 3) + 1;
+                for (int b = 0; b < 4; ++b)
+                    shuffle[control][4 * i + b] = b < bytes ? (uint8_t)source++ : 0x80;
+            }
+            length[control] = (uint8_t)source;
+        }
+    }
+};
+
+static const StreamVByteTables streamVByteTables;
+
+// Read-only adjacency with sorted neighbor lists stored as gaps in stream-vbyte
+// layout. Each list holds a varint degree, then one 2-bit length code per value,
+// then the value bytes. The first value is the zigzag offset of the first
+// neighbor from v; the rest are gaps between consecutive neighbors. List starts
+// are 32-bit offsets relative to a 64-bit base shared by each block of vertices.
+struct CompressedGraph
+{
+    static const int blockShift = 6; // 64 vertices share one base offset
+
+    int numVertices = 0;
+    size_t edgeCount = 0;
+    vector<uint64_t> blockBase; // Byte offset of the first list in each block
+    vector<uint32_t> offsets;   // Byte offset of each vertex's list from its block base
+    vector<uint8_t> bytes;      // Padded so 16-byte group loads never run past the end
+
+    static size_t varintSize(uint64_t value)
+    {
+        size_t size = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            size++;
+        }
+        return size;
+    }
+
+    static uint8_t *writeVarint(uint8_t *out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = (uint8_t)value;
+        return out;
+    }
+
+    static const uint8_t *readVarint(const uint8_t *in, uint64_t &value)
+    {
+        value = *in & 0x7f;
+        for (int shift = 7; *in++ & 0x80; shift += 7)
+        {
+            value |= (uint64_t)(*in & 0x7f) << shift;
+        }
+        return in;
+    }
+
+    static uint32_t zigzag(int64_t value)
+    {
+        return (uint32_t)(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    static int64_t unzigzag(uint32_t value)
+    {
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    // Length code 0..3 stands for 1..4 bytes
+    static int lengthCode(uint32_t value)
+    {
+        return value < (1u << 8) ? 0 : value < (1u << 16) ? 1 : value < (1u << 24) ? 2 : 3;
+    }
+
+    static size_t encodedSize(const vector<int> &list, int v)
+    {
+        size_t size = varintSize(list.size()) + (list.size() + 3) / 4;
+        for (size_t i = 0; i < list.size(); ++i)
+            size += lengthCode(i == 0 ? zigzag((int64_t)list[0] - v) : (uint32_t)(list[i] - list[i - 1])) + 1;
+        return size;
+    }
+
+    static void encode(uint8_t *out, const vector<int> &list, int v)
+    {
+        out = writeVarint(out, list.size());
+        uint8_t *control = out;
+        uint8_t *data = control + (list.size() + 3) / 4;
+        fill(control, data, 0);
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            uint32_t value = i == 0 ? zigzag((int64_t)list[0] - v) : (uint32_t)(list[i] - list[i - 1]);
+            int code = lengthCode(value);
+            control[i >> 2] |= code << ((i & 3) * 2);
+            for (int b = 0; b <= code; ++b)
+                *data++ = (uint8_t)(value >> (8 * b));
+        }
+    }
+
+    // Decode the four values of one control byte into out; returns data advanced past them.
+    // Slots beyond a list's degree decode to garbage and must be ignored by the caller.
+    static const uint8_t *decodeGroup(uint8_t control, const uint8_t *data, uint32_t out[4])
+    {
+#ifdef __AVX2__
+        __m128i packed = _mm_loadu_si128((const __m128i *)data);
+        __m128i mask = _mm_loadu_si128((const __m128i *)streamVByteTables.shuffle[control]);
+        _mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(packed, mask));
+#else
+        static const uint32_t masks[4] = {0xff, 0xffff, 0xffffff, 0xffffffff};
+        const uint8_t *p = data;
+        for (int i = 0; i < 4; ++i)
+        {
+            int code = (control >> (2 * i)) & 3;
+            uint32_t raw;
+            memcpy(&raw, p, sizeof(raw));
+            out[i] = raw & masks[code];
+            p += code + 1;
+        }
+#endif
+        return data + streamVByteTables.length[control];
+    }
+
+    // Forward iterator that decodes one neighbor list on the fly, a group of four at a time
+    class NeighborIterator
+    {
+    private:
+        const uint8_t *control = nullptr;
+        const uint8_t *data = nullptr;
+        size_t index = 0;
+        size_t remaining = 0;
+        int current = 0;
+        uint32_t group[4];
+
+    public:
+        NeighborIterator() = default;
+        NeighborIterator(const uint8_t *p, int v)
+        {
+            uint64_t degree;
+            control = readVarint(p, degree);
+            data = control + (degree + 3) / 4;
+            remaining = degree;
+            if (remaining > 0)
+            {
+                data = decodeGroup(control[0], data, group);
+                current = (int)(v + unzigzag(group[0]));
+            }
+        }
+
+        int operator*() const
+        {
+            return current;
+        }
+
+        NeighborIterator &operator++()
+        {
+            if (--remaining > 0)
+            {
+                if ((++index & 3) == 0)
+                    data = decodeGroup(control[index >> 2], data, group);
+                current += (int)group[index & 3];
+            }
+            return *this;
+        }
+
+        bool operator!=(const NeighborIterator &other) const
+        {
+            return remaining != other.remaining;
+        }
+    };
+
+    struct NeighborRange
+    {
+        NeighborIterator first;
+        NeighborIterator begin() const { return first; }
+        NeighborIterator end() const { return NeighborIterator(); }
+    };
+
+    const uint8_t *listStart(int v) const
+    {
+        return &bytes[blockBase[v >> blockShift] + offsets[v]];
+    }
+
+    size_t degree(int v) const
+    {
+        uint64_t value;
+        readVarint(listStart(v), value);
+        return value;
+    }
+
+    size_t numEdges() const
+    {
+        return edgeCount;
+    }
+
+    NeighborRange neighborsOf(int v) const
+    {
+        return {NeighborIterator(listStart(v), v)};
+    }
+
+    template <typename Fn>
+    void forEachNeighbor(int v, Fn fn) const
+    {
+        uint64_t degree;
+        const uint8_t *control = readVarint(listStart(v), degree);
+        const uint8_t *data = control + (degree + 3) / 4;
+        uint32_t group[4];
+        int current = v;
+        for (size_t i = 0; i < degree; ++i)
+        {
+            if ((i & 3) == 0)
+                data = decodeGroup(control[i >> 2], data, group);
+            current = i == 0 ? (int)(v + unzigzag(group[0])) : current + (int)group[i & 3];
+            if (!fn(current))
+                return;
+        }
+    }
+
+    size_t memoryBytes() const
+    {
+        return blockBase.size() * sizeof(uint64_t) + offsets.size() * sizeof(uint32_t) + bytes.size();
+    }
+
+    // Sort and encode every list in parallel: size pass, prefix sum, then encode pass
+    static CompressedGraph fromCSR(const CSRGraph &csr, int numThreads = 0)
+    {
+        CompressedGraph g;
+        int n = csr.numVertices;
+        numThreads = resolveThreadCount(numThreads);
+        g.numVertices = n;
+        g.edgeCount = csr.numEdges();
+
+        vector<vector<int>> scratch(numThreads);
+        auto sortedList = [&](int v, int id) -> vector<int> &
+        {
+            vector<int> &list = scratch[id];
+            list.assign(csr.neighbors.begin() + csr.offsets[v], csr.neighbors.begin() + csr.offsets[v + 1]);
+            sort(list.begin(), list.end());
+            return list;
+        };
+
+        vector<size_t> start(n + 1, 0);
+        parallelFor(n, numThreads, [&](size_t v, int id)
+                    { start[v + 1] = encodedSize(sortedList((int)v, id), (int)v); });
+        for (int v = 0; v < n; ++v)
+            start[v + 1] += start[v];
+
+        g.blockBase.resize(((size_t)n >> blockShift) + 1);
+        g.offsets.resize(n);
+        for (int v = 0; v < n; ++v)
+        {
+            if ((v & ((1 << blockShift) - 1)) == 0)
+                g.blockBase[v >> blockShift] = start[v];
+            g.offsets[v] = (uint32_t)(start[v] - g.blockBase[v >> blockShift]);
+        }
+
+        g.bytes.assign(start[n] + 16, 0);
+        parallelFor(n, numThreads, [&](size_t v, int id)
+                    { encode(&g.bytes[start[v]], sortedList((int)v, id), (int)v); });
+        return g;
+    }
+};
+
+// Highest-degree vertices of any graph representation
+template <typename GraphT>
+vector<pair<int, int>> topDegrees(const GraphT &graph, size_t k)
+{
+    vector<pair<int, int>> ranking;
+    for (int v = 0; v < graph.numVertices; ++v)
+        ranking.emplace_back(v, (int)graph.degree(v));
+
+    k = min(k, ranking.size());
+    partial_sort(ranking.begin(), ranking.begin() + k, ranking.end(), [](const auto &a, const auto &b)
+                 { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+    ranking.resize(k);
+    return ranking;
+}
+
+// Connected component labels plus size statistics
+struct ComponentResult
+{
+    vector<int> label;          // Dense component id per vertex
+    vector<int> componentSizes; // Indexed by component id
+    int numComponents = 0;
+    int largestComponent = -1;
+    int singletons = 0;
+};
+
+// Afforest connected components: lock-free union-find over sampled then remaining edges
+template <typename GraphT>
+class ParallelComponents
+{
+private:
+    const GraphT &graph;
+    int numThreads;
+    vector<atomic<int>> parent;
+
+    // Hook the higher root under the lower one; retries on concurrent updates
+    void link(int u, int v)
+    {
+        int p1 = parent[u].load(memory_order_relaxed);
+        int p2 = parent[v].load(memory_order_relaxed);
+        while (p1 != p2)
+        {
+            int high = max(p1, p2);
+            int low = min(p1, p2);
+            int parentOfHigh = parent[high].load(memory_order_relaxed);
+            if (parentOfHigh == low)
+                break;
+
+            int expected = high;
+            if (parentOfHigh == high &&
+                parent[high].compare_exchange_strong(expected, low, memory_order_relaxed))
+                break;
+
+            p1 = parent[parent[high].load(memory_order_relaxed)].load(memory_order_relaxed);
+            p2 = parent[low].load(memory_order_relaxed);
+        }
+    }
+
+    void compress()
+    {
+        parallelFor(graph.numVertices, numThreads, [&](size_t v, int)
+                    {
+            int p = parent[v].load(memory_order_relaxed);
+            while (p != parent[p].load(memory_order_relaxed))
+            {
+                p = parent[p].load(memory_order_relaxed);
+            }
+            parent[v].store(p, memory_order_relaxed); });
+    }
+
+    // Most frequent root among a fixed random sample of vertices
+    int sampleLargestComponent() const
+    {
+        const int numSamples = 1024;
+        mt19937 rng(27491095);
+        uniform_int_distribution<int> pick(0, graph.numVertices - 1);
+        unordered_map<int, int> counts;
+        int best = 0, bestCount = 0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            int root = parent[pick(rng)].load(memory_order_relaxed);
+            if (++counts[root] > bestCount)
+            {
+                bestCount = counts[root];
+                best = root;
+            }
+        }
+        return best;
+    }
+
+public:
+    ParallelComponents(const GraphT &g, int threads = 0)
+        : graph(g), numThreads(resolveThreadCount(threads)), parent(g.numVertices) {}
+
+    ComponentResult run(int neighborRounds = 2)
+    {
+        ComponentResult result;
+        int n = graph.numVertices;
+        if (n == 0)
+            return result;
+
+        parallelFor(n, numThreads, [&](size_t v, int)
+                    { parent[v].store((int)v, memory_order_relaxed); });
+
+        // Link along the first few edges of every vertex to form a skeleton
+        for (int r = 0; r < neighborRounds; ++r)
+        {
+            parallelFor(n, numThreads, [&](size_t v, int)
+                        {
+                int index = 0;
+                graph.forEachNeighbor((int)v, [&](int u)
+                                      {
+                    if (index++ < r)
+                        return true;
+                    link((int)v, u);
+                    return false; }); });
+            compress();
+        }
+
+        // Vertices already in the dominant component can skip their remaining edges
+        int giant = sampleLargestComponent();
+        parallelFor(n, numThreads, [&](size_t v, int)
+                    {
+            if (parent[v].load(memory_order_relaxed) == giant)
+                return;
+            int index = 0;
+            graph.forEachNeighbor((int)v, [&](int u)
+                                  {
+                if (index++ >= neighborRounds)
+                    link((int)v, u);
+                return true; }); });
+        compress();
+
+        // Dense relabeling and size statistics
+        result.label.resize(n);
+        vector<int> denseId(n, -1);
+        for (int v = 0; v < n; ++v)
+        {
+            int root = parent[v].load(memory_order_relaxed);
+            if (denseId[root] < 0)
+            {
+                denseId[root] = result.numComponents++;
+                result.componentSizes.push_back(0);
+            }
+            result.label[v] = denseId[root];
+            result.componentSizes[denseId[root]]++;
+        }
+        for (int c = 0; c < result.numComponents; ++c)
+        {
+            if (result.largestComponent < 0 || result.componentSizes[c] > result.componentSizes[result.largestComponent])
+                result.largestComponent = c;
+            if (result.componentSizes[c] == 1)
+                result.singletons++;
+        }
+        return result;
+    }
+};
+
+// Weighted CSR graph used by every level of community detection
+struct WeightedCSR
+{
+    int numVertices = 0;
+    vector<size_t> offsets;
+    vector<int> neighbors;
+    vector<double> weights;
+    vector<double> strength; // Sum of incident edge weights, self-loops included
+    double totalWeight = 0;  // Sum of all strengths (2m)
+};
+
+// Modularity-based community assignment
+struct CommunityResult
+{
+    vector<int> community;      // Dense community id per vertex
+    vector<int> communitySizes; // Indexed by community id
+    int numCommunities = 0;
+    double modularity = 0;
+    int levels = 0;
+};
+
+// Louvain community detection with Leiden refinement; deterministic for a fixed thread count
+class LouvainLeiden
+{
+private:
+    static const int batchSize = 4096; // Vertices per thread between synchronizations
+    static const int maxPasses = 32;
+    int numThreads;
+
+    // Per-thread sparse accumulator of edge weight towards neighbouring communities
+    struct Accumulator
+    {
+        vector<double> weight;
+        vector<char> seen;
+        vector<int> touched;
+
+        explicit Accumulator(int n) : weight(n, 0), seen(n, 0) {}
+
+        void add(int c, double w)
+        {
+            if (!seen[c])
+            {
+                seen[c] = 1;
+                touched.push_back(c);
+            }
+            weight[c] += w;
+        }
+
+        void reset()
+        {
+            for (int c : touched)
+            {
+                weight[c] = 0;
+                seen[c] = 0;
+            }
+            touched.clear();
+        }
+    };
+
+    // Per-thread record of the moves made in the current batch, plus its empty community ids
+    struct MoveOverlay
+    {
+        vector<double> totDelta;
+        vector<int> sizeDelta;
+        vector<char> seen;
+        vector<int> touched;
+        vector<int> emptyPool;
+        long long moves = 0;
+
+        explicit MoveOverlay(int n) : totDelta(n, 0), sizeDelta(n, 0), seen(n, 0) {}
+
+        void add(int c, double w, int members)
+        {
+            if (!seen[c])
+            {
+                seen[c] = 1;
+                touched.push_back(c);
+            }
+            totDelta[c] += w;
+            sizeDelta[c] += members;
+        }
+    };
+
+#ifdef DSA_LAB_CHECKS
+    // Invariant between batches: every pooled id is an empty community and appears only once
+    static void checkEmptyPools(const vector<MoveOverlay> &overlays, const vector<int> &size)
+    {
+        vector<char> listed(size.size(), 0);
+        for (const MoveOverlay &overlay : overlays)
+        {
+            for (int c : overlay.emptyPool)
+            {
+                if (size[c] != 0 || listed[c])
+                {
+                    cerr << "Empty-community pool holds " << (listed[c] ? "duplicate" : "occupied") << " id " << c << endl;
+                    abort();
+                }
+                listed[c] = 1;
+            }
+        }
+    }
+#endif
+
+    // Local moving phase. Each batch is cut into one contiguous slice per thread; a
+    // thread moves its slice sequentially against the batch-start state plus its own
+    // moves, and the overlays are merged in thread order at the end of the batch.
+    long long localMoving(const WeightedCSR &g, vector<int> &comm, vector<double> &tot, vector<int> &size) const
+    {
+        int n = g.numVertices;
+        int batch = batchSize * numThreads;
+        vector<Accumulator> accs(numThreads, Accumulator(n));
+        vector<MoveOverlay> overlays(numThreads, MoveOverlay(n));
+        vector<int> proposal(min(n, batch));
+        vector<char> pooled(n, 0);  // Set while c sits in its owner's empty pool
+        vector<char> merged(n, 0);
+        vector<int> mergedIds;
+        for (int c = n - 1; c >= 0; --c)
+        {
+            if (size[c] == 0)
+            {
+                overlays[c % numThreads].emptyPool.push_back(c);
+                pooled[c] = 1;
+            }
+        }
+
+        long long totalMoves = 0;
+        for (int pass = 0; pass < maxPasses; ++pass)
+        {
+            long long moves = 0;
+            for (int begin = 0; begin < n; begin += batch)
+            {
+                int end = min(n, begin + batch);
+                parallelRanges(end - begin, numThreads, [&](size_t lo, size_t hi, int id)
+                               {
+                    Accumulator &acc = accs[id];
+                    MoveOverlay &overlay = overlays[id];
+                    int sliceBegin = begin + (int)lo, sliceEnd = begin + (int)hi;
+                    for (int v = sliceBegin; v < sliceEnd; ++v)
+                        proposal[v - begin] = comm[v];
+
+                    for (int v = sliceBegin; v < sliceEnd; ++v)
+                    {
+                        int current = proposal[v - begin];
+                        double scale = g.strength[v] / g.totalWeight;
+                        acc.add(current, 0);
+                        for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+                        {
+                            int u = g.neighbors[e];
+                            if (u != v)
+                                acc.add(u >= sliceBegin && u < sliceEnd ? proposal[u - begin] : comm[u], g.weights[e]);
+                        }
+
+                        int currentSize = size[current] + overlay.sizeDelta[current];
+                        int best = current;
+                        double bestGain = acc.weight[current] - (tot[current] + overlay.totDelta[current] - g.strength[v]) * scale;
+                        for (int c : acc.touched)
+                        {
+                            // Two singletons may only merge towards the lower id, preventing swaps
+                            if (c == current || (currentSize == 1 && size[c] + overlay.sizeDelta[c] == 1 && c > current))
+                                continue;
+
+                            double gain = acc.weight[c] - (tot[c] + overlay.totDelta[c]) * scale;
+                            if (gain > bestGain || (gain == bestGain && best != current && c < best))
+                            {
+                                bestGain = gain;
+                                best = c;
+                            }
+                        }
+                        acc.reset();
+
+                        // An empty community gains nothing but may beat a bad fit
+                        if (bestGain < 0 && currentSize > 1)
+                        {
+                            while (!overlay.emptyPool.empty())
+                            {
+                                int c = overlay.emptyPool.back();
+                                overlay.emptyPool.pop_back();
+                                pooled[c] = 0;
+                                if (size[c] + overlay.sizeDelta[c] == 0)
+                                {
+                                    best = c;
+                                    break;
+                                }
+                            }
+                        }
+
+                        if (best != current)
+                        {
+                            overlay.add(current, -g.strength[v], -1);
+                            overlay.add(best, g.strength[v], 1);
+                            proposal[v - begin] = best;
+                            overlay.moves++;
+                        }
+                    } });
+
+                // Apply every overlay before looking for emptied communities: a community one
+                // thread emptied may have been joined by another thread in the same batch
+                for (MoveOverlay &overlay : overlays)
+                {
+                    for (int c : overlay.touched)
+                    {
+                        tot[c] += overlay.totDelta[c];
+                        size[c] += overlay.sizeDelta[c];
+                        overlay.totDelta[c] = 0;
+                        overlay.sizeDelta[c] = 0;
+                        overlay.seen[c] = 0;
+                        if (!merged[c])
+                        {
+                            merged[c] = 1;
+                            mergedIds.push_back(c);
+                        }
+                    }
+                    overlay.touched.clear();
+                    moves += overlay.moves;
+                    overlay.moves = 0;
+                }
+                sort(mergedIds.begin(), mergedIds.end(), greater<int>());
+                for (int c : mergedIds)
+                {
+                    merged[c] = 0;
+                    if (size[c] == 0 && !pooled[c])
+                    {
+                        overlays[c % numThreads].emptyPool.push_back(c);
+                        pooled[c] = 1;
+                    }
+                }
+                mergedIds.clear();
+                copy(proposal.begin(), proposal.begin() + (end - begin), comm.begin() + begin);
+#ifdef DSA_LAB_CHECKS
+                checkEmptyPools(overlays, size);
+#endif
+            }
+            totalMoves += moves;
+            if (moves == 0 || moves < n / 1000)
+                break;
+        }
+        return totalMoves;
+    }
+
+    // Group vertex ids by label, keeping ascending vertex order inside each group
+    static void bucket(const vector<int> &label, int numLabels, vector<int> &start, vector<int> &members)
+    {
+        start.assign(numLabels + 1, 0);
+        for (int l : label)
+            start[l + 1]++;
+        for (int i = 0; i < numLabels; ++i)
+            start[i + 1] += start[i];
+        members.resize(label.size());
+        vector<int> next(start.begin(), start.end() - 1);
+        for (int v = 0; v < (int)label.size(); ++v)
+            members[next[label[v]]++] = v;
+    }
+
+    // Leiden refinement: merge singletons into sub-communities of their own community
+    vector<int> refine(const WeightedCSR &g, const vector<int> &comm) const
+    {
+        int n = g.numVertices;
+        vector<int> refined(n);
+        vector<double> refinedTot(g.strength);
+        vector<int> refinedSize(n, 1);
+        for (int v = 0; v < n; ++v)
+            refined[v] = v;
+
+        vector<int> start, members;
+        bucket(comm, n, start, members);
+        vector<Accumulator> accs(numThreads, Accumulator(n));
+
+        parallelFor(n, numThreads, [&](size_t c, int id)
+                    {
+            Accumulator &acc = accs[id];
+            for (int idx = start[c]; idx < start[c + 1]; ++idx)
+            {
+                int v = members[idx];
+                if (refinedSize[refined[v]] != 1)
+                    continue;
+
+                for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+                {
+                    int u = g.neighbors[e];
+                    if (u != v && comm[u] == (int)c)
+                        acc.add(refined[u], g.weights[e]);
+                }
+
+                double scale = g.strength[v] / g.totalWeight;
+                int best = -1;
+                double bestGain = 0;
+                for (int r : acc.touched)
+                {
+                    double gain = acc.weight[r] - refinedTot[r] * scale;
+                    if (gain > bestGain || (gain == bestGain && best >= 0 && r < best))
+                    {
+                        bestGain = gain;
+                        best = r;
+                    }
+                }
+                acc.reset();
+
+                if (best >= 0)
+                {
+                    refinedTot[v] -= g.strength[v];
+                    refinedSize[v]--;
+                    refined[v] = best;
+                    refinedTot[best] += g.strength[v];
+                    refinedSize[best]++;
+                }
+            } }, 16);
+        return refined;
+    }
+
+    // Collapse each node group into one vertex; parallel per group with sorted neighbour lists
+    WeightedCSR aggregate(const WeightedCSR &g, const vector<int> &nodeOf, int numNodes) const
+    {
+        vector<int> start, members;
+        bucket(nodeOf, numNodes, start, members);
+
+        vector<vector<pair<int, double>>> lists(numNodes);
+        vector<Accumulator> accs(numThreads, Accumulator(numNodes));
+        parallelFor(numNodes, numThreads, [&](size_t c, int id)
+                    {
+            Accumulator &acc = accs[id];
+            for (int idx = start[c]; idx < start[c + 1]; ++idx)
+            {
+                int v = members[idx];
+                for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+                    acc.add(nodeOf[g.neighbors[e]], g.weights[e]);
+            }
+            sort(acc.touched.begin(), acc.touched.end());
+            for (int d : acc.touched)
+                lists[c].push_back({d, acc.weight[d]});
+            acc.reset(); }, 64);
+
+        WeightedCSR result;
+        result.numVertices = numNodes;
+        result.totalWeight = g.totalWeight;
+        result.offsets.assign(numNodes + 1, 0);
+        result.strength.assign(numNodes, 0);
+        for (int c = 0; c < numNodes; ++c)
+            result.offsets[c + 1] = result.offsets[c] + lists[c].size();
+        result.neighbors.resize(result.offsets[numNodes]);
+        result.weights.resize(result.offsets[numNodes]);
+        parallelFor(numNodes, numThreads, [&](size_t c, int)
+                    {
+            size_t pos = result.offsets[c];
+            for (const auto &entry : lists[c])
+            {
+                result.neighbors[pos] = entry.first;
+                result.weights[pos++] = entry.second;
+                result.strength[c] += entry.second;
+            } });
+        return result;
+    }
+
+    // Split communities into their connected pieces; this never lowers modularity
+    static void splitDisconnected(const WeightedCSR &g, vector<int> &comm)
+    {
+        int n = g.numVertices;
+        vector<int> piece(n, -1);
+        vector<int> queue;
+        int numPieces = 0;
+        for (int s = 0; s < n; ++s)
+        {
+            if (piece[s] >= 0)
+                continue;
+            piece[s] = numPieces;
+            queue.assign(1, s);
+            for (size_t head = 0; head < queue.size(); ++head)
+            {
+                int v = queue[head];
+                for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+                {
+                    int u = g.neighbors[e];
+                    if (piece[u] < 0 && comm[u] == comm[v])
+                    {
+                        piece[u] = numPieces;
+                        queue.push_back(u);
+                    }
+                }
+            }
+            numPieces++;
+        }
+        comm = move(piece);
+    }
+
+    // Renumber labels densely in order of first appearance
+    static int densify(vector<int> &label, int maxLabel)
+    {
+        vector<int> id(maxLabel, -1);
+        int count = 0;
+        for (int &l : label)
+        {
+            if (id[l] < 0)
+                id[l] = count++;
+            l = id[l];
+        }
+        return count;
+    }
+
+public:
+    explicit LouvainLeiden(int threads = 0) : numThreads(resolveThreadCount(threads)) {}
+
+    static WeightedCSR fromCSR(const CSRGraph &csr)
+    {
+        WeightedCSR g;
+        g.numVertices = csr.numVertices;
+        g.offsets = csr.offsets;
+        g.neighbors = csr.neighbors;
+        g.weights.assign(csr.neighbors.size(), 1.0);
+        g.strength.resize(csr.numVertices);
+        for (int v = 0; v < csr.numVertices; ++v)
+        {
+            g.strength[v] = (double)csr.degree(v);
+            g.totalWeight += g.strength[v];
+        }
+        return g;
+    }
+
+    static double modularity(const WeightedCSR &g, const vector<int> &comm, int numCommunities)
+    {
+        if (g.totalWeight == 0)
+            return 0;
+
+        vector<double> tot(numCommunities, 0);
+        double internal = 0;
+        for (int v = 0; v < g.numVertices; ++v)
+        {
+            tot[comm[v]] += g.strength[v];
+            for (size_t e = g.offsets[v]; e < g.offsets[v + 1]; ++e)
+            {
+                if (comm[g.neighbors[e]] == comm[v])
+                    internal += g.weights[e];
+            }
+        }
+        double q = internal / g.totalWeight;
+        for (double t : tot)
+            q -= (t / g.totalWeight) * (t / g.totalWeight);
+        return q;
+    }
+
+    CommunityResult run(const WeightedCSR &graph, int maxLevels = 16) const
+    {
+        CommunityResult result;
+        int n = graph.numVertices;
+        vector<int> nodeOfVertex(n);
+        vector<int> comm(n);
+        for (int v = 0; v < n; ++v)
+            nodeOfVertex[v] = comm[v] = v;
+
+        WeightedCSR level;
+        const WeightedCSR *g = &graph;
+        for (; result.levels < maxLevels && g->totalWeight > 0; ++result.levels)
+        {
+            int nodes = g->numVertices;
+            vector<double> tot(nodes, 0);
+            vector<int> size(nodes, 0);
+            for (int v = 0; v < nodes; ++v)
+            {
+                tot[comm[v]] += g->strength[v];
+                size[comm[v]]++;
+            }
+
+            if (localMoving(*g, comm, tot, size) == 0)
+                break;
+
+            // Aggregate the refined partition; its nodes start in their parent communities
+            vector<int> nodeOf = refine(*g, comm);
+            int numNodes = densify(nodeOf, nodes);
+            if (numNodes == nodes)
+                break;
+
+            vector<int> nextComm(numNodes);
+            for (int v = 0; v < nodes; ++v)
+                nextComm[nodeOf[v]] = comm[v];
+            densify(nextComm, nodes);
+
+            parallelFor(n, numThreads, [&](size_t v, int)
+                        { nodeOfVertex[v] = nodeOf[nodeOfVertex[v]]; });
+            WeightedCSR next = aggregate(*g, nodeOf, numNodes);
+            level = move(next);
+            g = &level;
+            comm = move(nextComm);
+        }
+
+        result.community.resize(n);
+        for (int v = 0; v < n; ++v)
+            result.community[v] = comm[nodeOfVertex[v]];
+        splitDisconnected(graph, result.community);
+        result.numCommunities = densify(result.community, n);
+        result.communitySizes.assign(result.numCommunities, 0);
+        for (int c : result.community)
+            result.communitySizes[c]++;
+        result.modularity = modularity(graph, result.community, result.numCommunities);
+        return result;
+    }
+};
+
+// Per-user triangle counts and local clustering coefficients
+struct TriangleResult
+{
+    vector<uint64_t> triangles; // Triangles through each vertex
+    vector<double> clustering;  // Local clustering coefficient of each vertex
+    uint64_t totalTriangles = 0;
+    double averageClustering = 0;
+};
+
+// Triangle counting on a degree-ordered DAG with sorted adjacency arrays
+class TriangleCounter
+{
+private:
+    int numThreads;
+
+    // Scalar merge of two sorted lists, calling onMatch for every common element
+    template <typename Fn>
+    static void intersectScalar(const int *a, size_t na, const int *b, size_t nb, Fn onMatch)
+    {
+        size_t i = 0, j = 0;
+        while (i < na && j < nb)
+        {
+            if (a[i] < b[j])
+                i++;
+            else if (a[i] > b[j])
+                j++;
+            else
+            {
+                onMatch(a[i]);
+                i++;
+                j++;
+            }
+        }
+    }
+
+    // Compare 8x8 blocks with AVX2, finishing the tails with the scalar merge
+    template <typename Fn>
+    static void intersect(const int *a, size_t na, const int *b, size_t nb, Fn onMatch)
+    {
+        size_t i = 0, j = 0;
+#ifdef __AVX2__
+        const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+        while (i + 8 <= na && j + 8 <= nb)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+            __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+            __m256i match = _mm256_cmpeq_epi32(va, vb);
+            for (int r = 1; r < 8; ++r)
+            {
+                vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+            }
+
+            unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(match));
+            while (mask)
+            {
+                onMatch(a[i + __builtin_ctz(mask)]);
+                mask &= mask - 1;
+            }
+
+            int maxA = a[i + 7], maxB = b[j + 7];
+            if (maxA <= maxB)
+                i += 8;
+            if (maxB <= maxA)
+                j += 8;
+        }
+#endif
+        intersectScalar(a + i, na - i, b + j, nb - j, onMatch);
+    }
+
+public:
+    explicit TriangleCounter(int threads = 0) : numThreads(resolveThreadCount(threads)) {}
+
+    TriangleResult run(const CSRGraph &graph) const
+    {
+        TriangleResult result;
+        int n = graph.numVertices;
+
+        // Simple sorted neighbour lists: no duplicates, no self-loops
+        vector<vector<int>> simple(n);
+        parallelFor(n, numThreads, [&](size_t v, int)
+                    {
+            vector<int> &list = simple[v];
+            list.assign(graph.neighbors.begin() + graph.offsets[v], graph.neighbors.begin() + graph.offsets[v + 1]);
+            sort(list.begin(), list.end());
+            list.erase(unique(list.begin(), list.end()), list.end());
+            list.erase(remove(list.begin(), list.end(), (int)v), list.end()); }, 256);
+
+        // Rank vertices by (degree, id) and orient every edge towards the higher rank
+        vector<int> byRank(n), rank(n);
+        for (int v = 0; v < n; ++v)
+            byRank[v] = v;
+        sort(byRank.begin(), byRank.end(), [&](int a, int b)
+             { return simple[a].size() != simple[b].size() ? simple[a].size() < simple[b].size() : a < b; });
+        for (int r = 0; r < n; ++r)
+            rank[byRank[r]] = r;
+
+        vector<size_t> offsets(n + 1, 0);
+        for (int r = 0; r < n; ++r)
+        {
+            size_t out = 0;
+            for (int u : simple[byRank[r]])
+                out += rank[u] > r;
+            offsets[r + 1] = offsets[r] + out;
+        }
+        vector<int> dag(offsets[n]);
+        parallelFor(n, numThreads, [&](size_t r, int)
+                    {
+            size_t pos = offsets[r];
+            for (int u : simple[byRank[r]])
+            {
+                if (rank[u] > (int)r)
+                    dag[pos++] = rank[u];
+            }
+            sort(dag.begin() + offsets[r], dag.begin() + pos); }, 256);
+
+        // Work chunks of roughly equal intersection cost, splitting high-degree vertices
+        vector<pair<size_t, size_t>> chunks;
+        const size_t chunkCost = 1 << 16;
+        size_t chunkBegin = 0, cost = 0;
+        for (int r = 0; r < n; ++r)
+        {
+            size_t outR = offsets[r + 1] - offsets[r];
+            for (size_t e = offsets[r]; e < offsets[r + 1]; ++e)
+            {
+                cost += outR + offsets[dag[e] + 1] - offsets[dag[e]];
+                if (cost >= chunkCost)
+                {
+                    chunks.push_back({chunkBegin, e + 1});
+                    chunkBegin = e + 1;
+                    cost = 0;
+                }
+            }
+        }
+        if (chunkBegin < offsets[n])
+            chunks.push_back({chunkBegin, offsets[n]});
+
+        vector<atomic<uint64_t>> count(n);
+        for (auto &c : count)
+            c.store(0, memory_order_relaxed);
+        atomic<uint64_t> total(0);
+
+        parallelFor(chunks.size(), numThreads, [&](size_t c, int)
+                    {
+            size_t e = chunks[c].first;
+            int r = int(upper_bound(offsets.begin(), offsets.end(), e) - offsets.begin()) - 1;
+            uint64_t chunkTotal = 0;
+            for (; e < chunks[c].second; ++e)
+            {
+                while (offsets[r + 1] <= e)
+                    r++;
+                int w = dag[e];
+                uint64_t found = 0;
+                intersect(&dag[offsets[r]], offsets[r + 1] - offsets[r], &dag[offsets[w]], offsets[w + 1] - offsets[w],
+                          [&](int x)
+                          {
+                              count[x].fetch_add(1, memory_order_relaxed);
+                              found++;
+                          });
+                if (found)
+                {
+                    count[r].fetch_add(found, memory_order_relaxed);
+                    count[w].fetch_add(found, memory_order_relaxed);
+                    chunkTotal += found;
+                }
+            }
+            total.fetch_add(chunkTotal, memory_order_relaxed); }, 1);
+
+        result.totalTriangles = total.load();
+        result.triangles.resize(n);
+        result.clustering.resize(n);
+        double clusteringSum = 0;
+        for (int v = 0; v < n; ++v)
+        {
+            uint64_t t = count[rank[v]].load(memory_order_relaxed);
+            double d = (double)simple[v].size();
+            result.triangles[v] = t;
+            result.clustering[v] = d > 1 ? 2.0 * t / (d * (d - 1)) : 0.0;
+            clusteringSum += result.clustering[v];
+        }
+        result.averageClustering = n > 0 ? clusteringSum / n : 0;
+        return result;
+    }
+};
+
+// Friend-of-friend candidate with its distance and number of shared connections
+struct FriendCandidate
+{
+    int user;
+    int hops;
+    int mutualFriends; // Neighbours on the previous BFS level (mutual friends for 2-hop candidates)
+};
+
+// k-hop neighbourhood queries with direction-optimizing BFS. Visited state is
+// epoch-stamped so it is reused across queries without clearing; keep one
+// instance per serving thread.
+template <typename GraphT>
+class KHopQuery
+{
+private:
+    static const int alpha = 14; // Top-down to bottom-up switch factor
+
+    const GraphT &graph;
+    vector<uint32_t> visitEpoch;
+    vector<uint8_t> depth;
+    vector<int> score;
+    vector<uint64_t> frontierBits;
+    vector<int> frontier, next, reached;
+    uint32_t epoch = 0;
+
+    bool visited(int v) const
+    {
+        return visitEpoch[v] == epoch;
+    }
+
+    void visit(int v, int level, int count)
+    {
+        visitEpoch[v] = epoch;
+        depth[v] = (uint8_t)level;
+        score[v] = count;
+        next.push_back(v);
+    }
+
+    void topDownStep(int level)
+    {
+        for (int u : frontier)
+        {
+            graph.forEachNeighbor(u, [&](int v)
+                                  {
+                if (!visited(v))
+                    visit(v, level, 1);
+                else if (depth[v] == level)
+                    score[v]++;
+                return true; });
+        }
+    }
+
+    // Unvisited vertices look for frontier neighbours in the bitmap
+    void bottomUpStep(int level, bool counting)
+    {
+        for (int u : frontier)
+            frontierBits[u >> 6] |= 1ULL << (u & 63);
+
+        for (int v = 0; v < graph.numVertices; ++v)
+        {
+            if (visited(v))
+                continue;
+            int count = 0;
+            graph.forEachNeighbor(v, [&](int u)
+                                  {
+                if (frontierBits[u >> 6] >> (u & 63) & 1)
+                    count++;
+                return counting || count == 0; });
+            if (count > 0)
+                visit(v, level, count);
+        }
+
+        for (int u : frontier)
+            frontierBits[u >> 6] = 0;
+    }
+
+public:
+    explicit KHopQuery(const GraphT &g)
+        : graph(g), visitEpoch(g.numVertices, 0), depth(g.numVertices, 0), score(g.numVertices, 0),
+          frontierBits((g.numVertices + 63) / 64, 0) {}
+
+    // Users within maxHops of user (excluding direct friends), best candidates first
+    vector<FriendCandidate> query(int user, int maxHops = 2, size_t limit = 20)
+    {
+        vector<FriendCandidate> candidates;
+        if (user < 0 || user >= graph.numVertices || maxHops < 2)
+            return candidates;
+
+        if (++epoch == 0)
+        {
+            fill(visitEpoch.begin(), visitEpoch.end(), 0);
+            epoch = 1;
+        }
+
+        reached.clear();
+        next.clear();
+        visit(user, 0, 0);
+        frontier.swap(next);
+        size_t unvisitedEdges = graph.numEdges() - graph.degree(user);
+
+        for (int level = 1; level <= maxHops && !frontier.empty(); ++level)
+        {
+            // Scores are needed from level 2 on, so bottom-up cannot stop at the first hit there
+            bool counting = level >= 2;
+            size_t frontierEdges = 0;
+            for (int u : frontier)
+                frontierEdges += graph.degree(u);
+
+            next.clear();
+            bool bottomUp = counting ? frontierEdges > unvisitedEdges + graph.numVertices / 64
+                                     : frontierEdges * alpha > unvisitedEdges;
+            if (bottomUp)
+                bottomUpStep(level, counting);
+            else
+                topDownStep(level);
+
+            for (int v : next)
+            {
+                unvisitedEdges -= graph.degree(v);
+                if (counting)
+                    reached.push_back(v);
+            }
+            frontier.swap(next);
+        }
+
+        // Closer first, then more shared connections, then lower id
+        auto better = [&](int a, int b)
+        {
+            if (depth[a] != depth[b])
+                return depth[a] < depth[b];
+            if (score[a] != score[b])
+                return score[a] > score[b];
+            return a < b;
+        };
+        size_t keep = min(limit, reached.size());
+        partial_sort(reached.begin(), reached.begin() + keep, reached.end(), better);
+        for (size_t i = 0; i < keep; ++i)
+        {
+            int v = reached[i];
+            candidates.push_back({v, depth[v], score[v]});
+        }
+        return candidates;
+    }
+};
+
+// What the bulk loader dropped while building the adjacency
+struct BulkLoadStats
+{
+    size_t inputEdges = 0;
+    size_t selfLoops = 0;
+    size_t invalidEdges = 0;
+    size_t duplicateEntries = 0; // Directed adjacency entries removed as repeats
+};
+
+// Bulk edge ingestion: parallel parse, symmetrize, bucket by source, sort and
+// deduplicate each list, then compact into the final CSR in one pass.
+class BulkEdgeLoader
+{
+private:
+    static bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // Read one vertex id at p: digits only, ending at a blank or line end, below INT_MAX so that
+    // the vertex count id + 1 still fits in an int
+    static bool parseVertex(const char *&p, const char *end, int &vertex)
+    {
+        const char *start = p;
+        long long value = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            value = value * 10 + (*p++ - '0');
+            if (value >= INT_MAX)
+                return false;
+        }
+        if (p == start || (p < end && *p != '\n' && !isBlank(*p)))
+            return false;
+        vertex = (int)value;
+        return true;
+    }
+
+    // Parse "u v" pairs from [begin, end); lines starting with '#' or '%' are comments, columns
+    // after the second (e.g. weights) are ignored, and lines whose ids are not plain non-negative
+    // integers below INT_MAX ("-1 5", "1x2 3", "7") are skipped
+    static void parseRange(const char *begin, const char *end, vector<pair<int, int>> &out)
+    {
+        const char *p = begin;
+        while (p < end)
+        {
+            while (p < end && isBlank(*p))
+                p++;
+            if (p < end && *p != '#' && *p != '%' && *p != '\n')
+            {
+                int u, v;
+                bool valid = parseVertex(p, end, u);
+                while (valid && p < end && isBlank(*p))
+                    p++;
+                if (valid && parseVertex(p, end, v))
+                    out.push_back({u, v});
+            }
+            while (p < end && *p != '\n')
+                p++;
+            p++;
+        }
+    }
+
+public:
+    // Parse a text edge list held in memory, splitting the work at line boundaries
+    static vector<pair<int, int>> parseEdgeList(const char *data, size_t size, int numThreads = 0)
+    {
+        numThreads = resolveThreadCount(numThreads);
+        vector<size_t> cuts(numThreads + 1, size);
+        cuts[0] = 0;
+        for (int t = 1; t < numThreads; ++t)
+        {
+            size_t cut = max(cuts[t - 1], size * t / numThreads);
+            while (cut < size && cut > 0 && data[cut - 1] != '\n')
+                cut++;
+            cuts[t] = cut;
+        }
+
+        vector<vector<pair<int, int>>> parts(numThreads);
+        parallelFor(numThreads, numThreads, [&](size_t part, int)
+                    { parseRange(data + cuts[part], data + cuts[part + 1], parts[part]); }, 1);
+
+        vector<pair<int, int>> edges;
+        for (const auto &part : parts)
+            edges.insert(edges.end(), part.begin(), part.end());
+        return edges;
+    }
+
+    // Read and parse an edge list file; returns false if it cannot be opened
+    static bool loadEdgeListFile(const string &path, vector<pair<int, int>> &edges, int numThreads = 0)
+    {
+        ifstream file(path, ios::binary);
+        if (!file)
+            return false;
+
+        ostringstream buffer;
+        buffer << file.rdbuf();
+        string data = buffer.str();
+        edges = parseEdgeList(data.data(), data.size(), numThreads);
+        return true;
+    }
+
+    // Build a simple undirected CSR graph; numVertices < 0 means max id + 1
+    static CSRGraph build(const vector<pair<int, int>> &edges, int numVertices = -1, int numThreads = 0,
+                          BulkLoadStats *stats = nullptr)
+    {
+        numThreads = resolveThreadCount(numThreads);
+        if (numVertices < 0)
+        {
+            // An endpoint of INT_MAX cannot be counted in an int; such edges end up as invalid
+            numVertices = 0;
+            for (const auto &edge : edges)
+            {
+                if (edge.first < INT_MAX && edge.second < INT_MAX)
+                    numVertices = max(numVertices, max(edge.first, edge.second) + 1);
+            }
+        }
+        int n = numVertices;
+        auto usable = [&](const pair<int, int> &edge)
+        {
+            return edge.first != edge.second && edge.first >= 0 && edge.second >= 0 && edge.first < n && edge.second < n;
+        };
+
+        // Degree histogram of the symmetrized edge list
+        vector<atomic<size_t>> cursor(n + 1);
+        for (auto &c : cursor)
+            c.store(0, memory_order_relaxed);
+        parallelFor(edges.size(), numThreads, [&](size_t i, int)
+                    {
+            if (usable(edges[i]))
+            {
+                cursor[edges[i].first + 1].fetch_add(1, memory_order_relaxed);
+                cursor[edges[i].second + 1].fetch_add(1, memory_order_relaxed);
+            } }, 4096);
+
+        vector<size_t> bucketStart(n + 1, 0);
+        for (int v = 0; v < n; ++v)
+        {
+            bucketStart[v + 1] = bucketStart[v] + cursor[v + 1].load(memory_order_relaxed);
+            cursor[v].store(bucketStart[v], memory_order_relaxed);
+        }
+
+        // Scatter both directions of every edge into its source bucket
+        vector<int> buckets(bucketStart[n]);
+        parallelFor(edges.size(), numThreads, [&](size_t i, int)
+                    {
+            if (usable(edges[i]))
+            {
+                buckets[cursor[edges[i].first].fetch_add(1, memory_order_relaxed)] = edges[i].second;
+                buckets[cursor[edges[i].second].fetch_add(1, memory_order_relaxed)] = edges[i].first;
+            } }, 4096);
+
+        // Sort and deduplicate each bucket, then compact into the final arrays
+        vector<size_t> uniqueCount(n);
+        parallelFor(n, numThreads, [&](size_t v, int)
+                    {
+            auto first = buckets.begin() + bucketStart[v];
+            auto last = buckets.begin() + bucketStart[v + 1];
+            sort(first, last);
+            uniqueCount[v] = unique(first, last) - first; }, 256);
+
+        CSRGraph csr;
+        csr.numVertices = n;
+        csr.offsets.assign(n + 1, 0);
+        for (int v = 0; v < n; ++v)
+            csr.offsets[v + 1] = csr.offsets[v] + uniqueCount[v];
+        csr.neighbors.resize(csr.offsets[n]);
+        parallelFor(n, numThreads, [&](size_t v, int)
+                    { copy_n(buckets.begin() + bucketStart[v], uniqueCount[v], csr.neighbors.begin() + csr.offsets[v]); }, 256);
+
+        if (stats)
+        {
+            stats->inputEdges = edges.size();
+            stats->selfLoops = stats->invalidEdges = 0;
+            for (const auto &edge : edges)
+            {
+                if (edge.first < 0 || edge.second < 0 || edge.first >= n || edge.second >= n)
+                    stats->invalidEdges++;
+                else if (edge.first == edge.second)
+                    stats->selfLoops++;
+            }
+            stats->duplicateEntries = buckets.size() - csr.neighbors.size();
+        }
+        return csr;
+    }
+};
+
+// Incremental degree, top-k and component tracking over a stream of edge
+// insertions. Degrees only grow, so a vertex outside the size-k min-heap never
+// exceeds the heap minimum and the heap stays exact. Single writer.
+class StreamingGraphStats
+{
+private:
+    size_t k;
+    vector<int> degrees;
+    vector<int> parent;        // Union-find forest
+    vector<int> componentSize; // Valid at roots
+    int components = 0;
+    unordered_set<uint64_t> seenEdges;
+
+    vector<int> heap;        // Min-heap of vertex ids keyed by degree
+    vector<int> heapIndex;   // Position in heap, -1 when absent
+
+    void ensureVertex(int v)
+    {
+        while ((int)degrees.size() <= v)
+        {
+            int id = degrees.size();
+            degrees.push_back(0);
+            parent.push_back(id);
+            componentSize.push_back(1);
+            heapIndex.push_back(-1);
+            components++;
+        }
+    }
+
+    // Ranking order of the top-k: lower degree ranks below, and so does the higher id on equal degree
+    bool ranksBelow(int a, int b) const
+    {
+        return degrees[a] != degrees[b] ? degrees[a] < degrees[b] : a > b;
+    }
+
+    bool heapLess(int i, int j) const
+    {
+        return ranksBelow(heap[i], heap[j]);
+    }
+
+    void heapSwap(int i, int j)
+    {
+        swap(heap[i], heap[j]);
+        heapIndex[heap[i]] = i;
+        heapIndex[heap[j]] = j;
+    }
+
+    void siftUp(int i)
+    {
+        while (i > 0 && heapLess(i, (i - 1) / 2))
+        {
+            heapSwap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void siftDown(int i)
+    {
+        int size = heap.size();
+        while (true)
+        {
+            int smallest = i;
+            for (int c = 2 * i + 1; c <= 2 * i + 2 && c < size; ++c)
+            {
+                if (heapLess(c, smallest))
+                    smallest = c;
+            }
+            if (smallest == i)
+                return;
+            heapSwap(i, smallest);
+            i = smallest;
+        }
+    }
+
+    // Called after v's degree grew by one
+    void updateTopK(int v)
+    {
+        if (k == 0)
+            return;
+        if (heapIndex[v] >= 0)
+        {
+            siftDown(heapIndex[v]);
+        }
+        else if (heap.size() < k)
+        {
+            heap.push_back(v);
+            heapIndex[v] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+        }
+        else if (ranksBelow(heap[0], v))
+        {
+            heapIndex[heap[0]] = -1;
+            heap[0] = v;
+            heapIndex[v] = 0;
+            siftDown(0);
+        }
+    }
+
+    int find(int v)
+    {
+        while (parent[v] != v)
+        {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+public:
+    explicit StreamingGraphStats(size_t topK = 100, int initialVertices = 0) : k(topK)
+    {
+        if (initialVertices > 0)
+            ensureVertex(initialVertices - 1);
+    }
+
+    // Consume one friendship event; repeats and self-loops are ignored
+    bool addEdge(int u, int v)
+    {
+        if (u < 0 || v < 0 || u == v)
+            return false;
+        uint64_t key = (uint64_t)min(u, v) << 32 | (uint32_t)max(u, v);
+        if (!seenEdges.insert(key).second)
+            return false;
+
+        ensureVertex(max(u, v));
+        degrees[u]++;
+        updateTopK(u);
+        degrees[v]++;
+        updateTopK(v);
+
+        int a = find(u), b = find(v);
+        if (a != b)
+        {
+            if (componentSize[a] < componentSize[b])
+                swap(a, b);
+            parent[b] = a;
+            componentSize[a] += componentSize[b];
+            components--;
+        }
+        return true;
+    }
+
+    int degree(int v) const
+    {
+        return v >= 0 && v < (int)degrees.size() ? degrees[v] : 0;
+    }
+
+    // Most-connected users, highest degree first
+    vector<pair<int, int>> topK() const
+    {
+        vector<pair<int, int>> result;
+        for (int v : heap)
+            result.emplace_back(v, degrees[v]);
+        sort(result.begin(), result.end(), [](const auto &a, const auto &b)
+             { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+        return result;
+    }
+
+    // Representative id of v's component (-1 for an unseen user)
+    int component(int v)
+    {
+        return v >= 0 && v < (int)parent.size() ? find(v) : -1;
+    }
+
+    int componentSizeOf(int v)
+    {
+        return v >= 0 && v < (int)parent.size() ? componentSize[find(v)] : 0;
+    }
+
+    int numComponents() const
+    {
+        return components;
+    }
+};
+
 class Graph
 {
 private:
     unordered_map<int, vector<int>> adjList; // Adjacency List
     int numVertices;
 
+    // Compressed snapshot behind degreeCentrality; rebuilt on first use after an edit
+    mutable CompressedGraph compressedCache;
+    mutable bool compressedStale = true;
+
 public:
     Graph() : numVertices(0) {}
 
@@ -24,6 +1749,7 @@ public:
     void addVertex()
     {
         numVertices++;
+        compressedStale = true;
     }
 
     // Add an undirected edge
@@ -36,6 +1762,7 @@ public:
         }
         adjList[u].push_back(v);
         adjList[v].push_back(u);
+        compressedStale = true;
     }
 
     // Print adjacency list
@@ -53,30 +1780,35 @@ public:
         }
     }
 
-    // Find degree centrality
-    void degreeCentrality()
+    // Read-only compressed snapshot of the current adjacency, encoded once and reused until the next edit.
+    // Like the other queries it must not run concurrently with addVertex, addEdge or bulkLoad.
+    const CompressedGraph &compressedSnapshot(int numThreads = 0) const
     {
-        vector<pair<int, int>> centrality;
-        for (const auto &pair : adjList)
+        if (compressedStale)
         {
-            centrality.emplace_back(pair.first, pair.second.size());
+            compressedCache = CompressedGraph::fromCSR(buildCSR(numThreads), numThreads);
+            compressedStale = false;
         }
+        return compressedCache;
+    }
 
-        sort(centrality.begin(), centrality.end(), [](const auto &a, const auto &b)
-             { return a.second > b.second; });
-
-        cout << "Degree Centrality:\n";
-        for (const auto &entry : centrality)
-        {
-            cout << "Node " << entry.first << ": " << entry.second << endl;
-        }
+    // Degree centrality of every connected vertex, highest first (ties by id), read from the compressed snapshot
+    vector<pair<int, int>> degreeCentrality(int numThreads = 0) const
+    {
+        const CompressedGraph &compressed = compressedSnapshot(numThreads);
+        vector<pair<int, int>> centrality = topDegrees(compressed, compressed.numVertices);
+        while (!centrality.empty() && centrality.back().second == 0)
+            centrality.pop_back();
+        return centrality;
     }
 
     // Community detection using connected components
-    void detectCommunities()
+    CommunityList detectCommunities()
     {
+        CommunityList result;
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
         vector<bool> visited(numVertices, false);
-        vector<vector<int>> communities;
+        vector<vector<int>> &communities = result.communities;
 
         for (int i = 0; i < numVertices; ++i)
         {
@@ -92,9 +1824,11 @@ public:
                     int node = q.front();
                     q.pop();
                     community.push_back(node);
+                    DSA_STAT(result.stats.nodesSettled++);
 
                     for (int neighbor : adjList[node])
                     {
+                        DSA_STAT(result.stats.edgesRelaxed++);
                         if (!visited[neighbor])
                         {
                             visited[neighbor] = true;
@@ -104,22 +1838,84 @@ public:
                 }
 
                 communities.push_back(community);
+                DSA_STAT(result.stats.iterations++);
             }
         }
 
-        cout << "Communities Detected:\n";
-        for (const auto &community : communities)
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
+    }
+
+    // Replace the graph with a bulk-loaded, deduplicated edge list
+    BulkLoadStats bulkLoad(const vector<pair<int, int>> &edges, int vertices = -1, int numThreads = 0)
+    {
+        BulkLoadStats stats;
+        CSRGraph csr = BulkEdgeLoader::build(edges, vertices, numThreads, &stats);
+
+        adjList.clear();
+        adjList.reserve(csr.numVertices);
+        numVertices = csr.numVertices;
+        for (int v = 0; v < numVertices; ++v)
+        {
+            if (csr.degree(v) > 0)
+                adjList[v].assign(csr.neighbors.begin() + csr.offsets[v], csr.neighbors.begin() + csr.offsets[v + 1]);
+        }
+        compressedStale = true;
+        return stats;
+    }
+
+    // Bulk load from an edge list file
+    bool bulkLoadFile(const string &path, int numThreads = 0)
+    {
+        vector<pair<int, int>> edges;
+        if (!BulkEdgeLoader::loadEdgeListFile(path, edges, numThreads))
+        {
+            cout << "Could not open edge list " << path << "!\n";
+            return false;
+        }
+        bulkLoad(edges, -1, numThreads);
+        return true;
+    }
+
+    // Build a simple CSR snapshot of the adjacency list. addEdge keeps repeated friendships and
+    // self-loops, so they are collapsed by the bulk loader's sort and dedup; otherwise
+    // degrees and mutual-friend counts would count the same friend twice.
+    CSRGraph buildCSR(int numThreads = 0) const
+    {
+        vector<pair<int, int>> edges;
+        for (const auto &entry : adjList)
         {
-            cout << "Community: ";
-            for (int node : community)
+            for (int neighbor : entry.second)
             {
-                cout << node << " ";
+                if (entry.first < neighbor)
+                    edges.push_back({entry.first, neighbor});
             }
-            cout << endl;
         }
+        return BulkEdgeLoader::build(edges, numVertices, numThreads);
+    }
+
+    // Connected components with the parallel union-find engine
+    ComponentResult connectedComponents(int numThreads = 0) const
+    {
+        CSRGraph csr = buildCSR(numThreads);
+        return ParallelComponents<CSRGraph>(csr, numThreads).run();
+    }
+
+    // Modularity-based communities (Louvain with Leiden refinement)
+    CommunityResult detectModularityCommunities(int numThreads = 0) const
+    {
+        WeightedCSR weighted = LouvainLeiden::fromCSR(buildCSR(numThreads));
+        return LouvainLeiden(numThreads).run(weighted);
+    }
+
+    // Triangle counts and local clustering coefficients per user
+    TriangleResult countTriangles(int numThreads = 0) const
+    {
+        return TriangleCounter(numThreads).run(buildCSR(numThreads));
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     Graph g;
@@ -143,10 +1939,105 @@ int main()
     g.printAdjList();
 
     // Find degree centrality
-    g.degreeCentrality();
+    auto printCentrality = [](const vector<pair<int, int>> &centrality)
+    {
+        cout << "Degree Centrality:\n";
+        for (const auto &entry : centrality)
+        {
+            cout << "Node " << entry.first << ": " << entry.second << endl;
+        }
+    };
+    printCentrality(g.degreeCentrality());
 
     // Detect communities
-    g.detectCommunities();
+    CommunityList groups = g.detectCommunities();
+    cout << "Communities Detected:\n";
+    for (const auto &community : groups.communities)
+    {
+        cout << "Community: ";
+        for (int node : community)
+        {
+            cout << node << " ";
+        }
+        cout << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(groups.stats);
+#endif
+
+    // Summarize components with the parallel engine
+    ComponentResult components = g.connectedComponents();
+    cout << "Connected Components: " << components.numComponents << endl;
+    if (components.largestComponent >= 0)
+    {
+        cout << "Largest component size: " << components.componentSizes[components.largestComponent] << endl;
+    }
+    cout << "Isolated users: " << components.singletons << endl;
+
+    // Modularity-based community detection
+    CommunityResult communities = g.detectModularityCommunities();
+    cout << "Modularity Communities: " << communities.numCommunities
+         << " (modularity " << communities.modularity << ")\n";
+    for (int v = 0; v < (int)communities.community.size(); ++v)
+    {
+        cout << "Node " << v << ": community " << communities.community[v] << endl;
+    }
+
+    // Triangles and clustering coefficients
+    TriangleResult triangles = g.countTriangles();
+    cout << "Total triangles: " << triangles.totalTriangles << endl;
+    for (int v = 0; v < (int)triangles.triangles.size(); ++v)
+    {
+        cout << "Node " << v << ": " << triangles.triangles[v] << " triangles, clustering "
+             << triangles.clustering[v] << endl;
+    }
+
+    // People you may know, up to 3 hops away
+    CSRGraph csr = g.buildCSR();
+    KHopQuery<CSRGraph> friendQuery(csr);
+    cout << "Friend suggestions for user 3:\n";
+    for (const auto &candidate : friendQuery.query(3, 3))
+    {
+        cout << "User " << candidate.user << " (" << candidate.hops << " hops, "
+             << candidate.mutualFriends << " mutual)" << endl;
+    }
+
+    // Same queries over the compressed adjacency
+    CompressedGraph compressed = CompressedGraph::fromCSR(csr);
+    cout << "CSR bytes: " << csr.memoryBytes() << ", compressed bytes: " << compressed.memoryBytes() << endl;
+    cout << "Top users by degree (compressed):\n";
+    for (const auto &entry : topDegrees(compressed, 3))
+    {
+        cout << "Node " << entry.first << ": " << entry.second << endl;
+    }
+    ComponentResult compressedComponents = ParallelComponents<CompressedGraph>(compressed).run();
+    cout << "Connected Components (compressed): " << compressedComponents.numComponents << endl;
+    KHopQuery<CompressedGraph> compressedQuery(compressed);
+    cout << "Friend suggestions for user 3 (compressed): " << compressedQuery.query(3, 3).size() << endl;
+
+    // Bulk load an edge list with repeated friendships and a self-loop
+    const string edgeText = "# user friend\n0 1\n1 0\n0 2\n1 2\n2 2\n3 4\n4 5\n4 5\n";
+    Graph bulk;
+    BulkLoadStats stats = bulk.bulkLoad(BulkEdgeLoader::parseEdgeList(edgeText.data(), edgeText.size()));
+    cout << "Bulk loaded " << stats.inputEdges << " edges, dropped " << stats.selfLoops << " self-loops and "
+         << stats.duplicateEntries << " duplicate entries\n";
+    printCentrality(bulk.degreeCentrality());
+
+    // Streaming friendship events
+    StreamingGraphStats stream(3);
+    int events[][2] = {{0, 1}, {1, 2}, {0, 2}, {1, 0}, {3, 4}, {4, 5}, {1, 3}};
+    for (const auto &event : events)
+    {
+        stream.addEdge(event[0], event[1]);
+    }
+    cout << "Streaming top users by degree:\n";
+    for (const auto &entry : stream.topK())
+    {
+        cout << "Node " << entry.first << ": " << entry.second << endl;
+    }
+    cout << "Component of user 5 has " << stream.componentSizeOf(5) << " users; "
+         << stream.numComponents() << " components total\n";
     system("pause");
     return 0;
 }
+#endif
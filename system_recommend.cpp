@@ -9,8 +9,231 @@
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <random>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "dsa_stats.h"
 using namespace std;
 
+struct RecommendationResult
+{
+    vector<pair<int, int>> items; // (item, score), best first
+    SearchStats stats;
+};
+
+// Resolve a requested worker count (0 = all hardware threads)
+int resolveThreadCount(int requested)
+{
+    return requested > 0 ? requested : max(1u, thread::hardware_concurrency());
+}
+
+// Run fn(index, threadId) for every index in [0, count), handing out blocks dynamically
+template <typename Fn>
+void parallelFor(size_t count, int numThreads, Fn fn, size_t blockSize = 64)
+{
+    numThreads = (int)max<size_t>(1, min<size_t>(numThreads, (count + blockSize - 1) / blockSize));
+    atomic<size_t> nextBlock(0);
+    auto worker = [&](int id)
+    {
+        for (size_t begin = nextBlock.fetch_add(blockSize); begin < count; begin = nextBlock.fetch_add(blockSize))
+        {
+            size_t end = min(count, begin + blockSize);
+            for (size_t i = begin; i < end; ++i)
+            {
+                fn(i, id);
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int id = 1; id < numThreads; ++id)
+    {
+        threads.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+// Dot product of two float rows; n must be a multiple of 8
+inline float dotProduct(const float *a, const float *b, size_t n)
+{
+#ifdef __AVX2__
+    __m256 acc = _mm256_setzero_ps();
+    for (size_t i = 0; i < n; i += 8)
+    {
+#ifdef __FMA__
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#endif
+    }
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#else
+    float sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+#endif
+}
+
+// Solve A x = b in place for a symmetric positive definite n x n matrix (lower triangle is read)
+bool choleskySolve(vector<double> &A, vector<double> &b, int n)
+{
+    for (int j = 0; j < n; ++j)
+    {
+        double d = A[j * n + j];
+        for (int p = 0; p < j; ++p)
+            d -= A[j * n + p] * A[j * n + p];
+        if (d <= 0)
+            return false;
+        A[j * n + j] = sqrt(d);
+        for (int i = j + 1; i < n; ++i)
+        {
+            double v = A[i * n + j];
+            for (int p = 0; p < j; ++p)
+                v -= A[i * n + p] * A[j * n + p];
+            A[i * n + j] = v / A[j * n + j];
+        }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        for (int p = 0; p < i; ++p)
+            b[i] -= A[i * n + p] * b[p];
+        b[i] /= A[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; --i)
+    {
+        for (int p = i + 1; p < n; ++p)
+            b[i] -= A[p * n + i] * b[p];
+        b[i] /= A[i * n + i];
+    }
+    return true;
+}
+
+enum class SimilarityMetric
+{
+    Cosine,
+    Jaccard
+};
+
+// Top-k item neighbours in CSR layout: neighbours of i are [offsets[i], offsets[i + 1])
+struct ItemSimilarityIndex
+{
+    int numItems = 0;
+    vector<size_t> offsets;
+    vector<int> neighbors;
+    vector<float> similarity;
+};
+
+// Flat bipartite interaction graph in CSR form, in both directions
+struct BipartiteCSR
+{
+    vector<size_t> userOffsets; // Items of user u are userItems[userOffsets[u] .. userOffsets[u + 1])
+    vector<int> userItems;
+    vector<size_t> itemOffsets; // Users of item i are itemUsers[itemOffsets[i] .. itemOffsets[i + 1])
+    vector<int> itemUsers;
+};
+
+// Budget and stopping rule for random-walk recommendations
+struct WalkConfig
+{
+    size_t stepBudget = 100000;      // Item -> user -> item hops across all threads
+    double restartProbability = 0.3; // Chance of jumping back to one of the query items
+    int minVisits = 4;               // A candidate counts as settled after this many visits
+    size_t settledCandidates = 50;   // Stop early once this many candidates are settled
+    int numThreads = 1;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+};
+
+// Hyper-parameters for implicit-feedback ALS; confidence of an interaction is 1 + alpha * count
+struct ALSConfig
+{
+    int factors = 32;
+    int iterations = 10;
+    double regularization = 0.1;
+    double alpha = 40.0;
+    int numThreads = 0;
+    uint64_t seed = 42;
+};
+
+// Latent factors, row-major with every row padded to stride floats (a multiple of 8)
+struct FactorModel
+{
+    int factors = 0;
+    size_t stride = 0;
+    vector<float> userFactors;
+    vector<float> itemFactors;
+};
+
+// Inverted-file index over item factors: items grouped by nearest centroid, each list stored contiguously
+struct FactorIndex
+{
+    int numLists = 0;
+    vector<float> centroids;   // numLists rows of model stride
+    vector<size_t> listOffsets; // Items of list l are listItems[listOffsets[l] .. listOffsets[l + 1])
+    vector<int> listItems;
+    vector<float> listFactors; // Item factors in listItems order
+};
+
+// Rows grouped into fixed-size chunks; snapshots share chunks, so a publish copies only the chunks holding dirty rows
+template <typename Row>
+struct SharedRowTable
+{
+    static constexpr size_t chunkSize = 1024;
+    using Chunk = vector<shared_ptr<const Row>>;
+    vector<shared_ptr<Chunk>> chunks;
+
+    shared_ptr<const Row> &slot(size_t i) const
+    {
+        return (*chunks[i / chunkSize])[i % chunkSize];
+    }
+
+    // Slot of row i in a chunk private to this table, copying a shared chunk once (tracked in copied)
+    shared_ptr<const Row> &writableSlot(size_t i, vector<char> &copied)
+    {
+        size_t k = i / chunkSize;
+        if (k >= chunks.size())
+            chunks.resize(k + 1);
+        copied.resize(chunks.size(), 0);
+        if (!copied[k])
+        {
+            auto fresh = make_shared<Chunk>(chunkSize);
+            if (chunks[k])
+                for (size_t r = 0; r < chunkSize; ++r)
+                    (*fresh)[r] = atomic_load(&(*chunks[k])[r]);
+            chunks[k] = move(fresh);
+            copied[k] = 1;
+        }
+        return slot(i);
+    }
+};
+
+// Immutable view of the online state; readers hold it through a shared_ptr while writers publish the next one
+struct OnlineSnapshot
+{
+    uint64_t version = 0;
+    int numUsers = 0, numItems = 0;
+    SharedRowTable<vector<int>> userItems;                // Per user
+    SharedRowTable<vector<pair<int, int>>> cooccurrence; // Per item: (other item, users holding both), sorted
+    // Per-user cached recommendations, filled lazily by readers with atomic_load/atomic_store. A cache
+    // chunk is shared between snapshots only while none of its users are stale, so entries agree.
+    SharedRowTable<vector<pair<int, int>>> cache;
+};
+
 class RecommendationSystem
 {
 private:
@@ -18,30 +241,299 @@ private:
     int numUsers;
     int numItems;
 
+    vector<vector<int>> userItems; // Sorted, deduplicated items of each user
+    vector<vector<int>> itemUsers; // Inverted index: users who interacted with each item
+
+    // Reusable dense scoring state; one per thread in batch mode
+    struct ScoringScratch
+    {
+        vector<int> overlap;    // Items shared with the target user, per co-user
+        vector<int> itemScore;
+        vector<char> ownedItem; // Bitmap of the target user's items
+        vector<int> touchedUsers, touchedItems;
+
+        void resize(int users, int items)
+        {
+            overlap.resize(users, 0);
+            itemScore.resize(items, 0);
+            ownedItem.resize(items, 0);
+        }
+    };
+
+    ScoringScratch scratch;
+    BipartiteCSR walkGraph;
+    vector<vector<uint32_t>> walkVisits; // Per-thread visit counters, zero between calls
+    ItemSimilarityIndex itemSimilarity;
+    vector<float> similarityScore;
+    FactorModel model;
+    FactorIndex factorIndex;
+
+    // Online update state, guarded by updateMutex; readers only see onlineSnapshot
+    mutex updateMutex;
+    bool onlineEnabled = false;
+    size_t onlineCacheDepth = 0;
+    vector<unordered_map<int, int>> coCounts; // Item-item co-occurrence, kept current by addInteraction
+    vector<char> dirtyItem, dirtyUser, staleUser;
+    vector<int> dirtyItems, dirtyUsers, staleUsers;
+    shared_ptr<const OnlineSnapshot> onlineSnapshot;
+
+    void markDirty(vector<char> &flags, vector<int> &list, int id)
+    {
+        if ((size_t)id >= flags.size())
+            flags.resize(id + 1, 0);
+        if (!flags[id])
+        {
+            flags[id] = 1;
+            list.push_back(id);
+        }
+    }
+
+    // Build the next snapshot: only chunks holding dirty item rows, dirty user lists or stale
+    // caches are copied (cost grows with the dirty set, plus one pointer per 1024 rows), and
+    // only users holding a dirty item lose their cached recommendations. Caller holds updateMutex.
+    size_t publishLocked()
+    {
+        shared_ptr<const OnlineSnapshot> old = atomic_load(&onlineSnapshot);
+        auto next = make_shared<OnlineSnapshot>();
+        if (old)
+            *next = *old;
+        next->version++;
+        next->numUsers = numUsers;
+        next->numItems = numItems;
+
+        int oldUsers = old ? old->numUsers : 0;
+        int oldItems = old ? old->numItems : 0;
+        for (int user = oldUsers; user < numUsers; ++user)
+            markDirty(dirtyUser, dirtyUsers, user);
+        for (int item = oldItems; item < numItems; ++item)
+            markDirty(dirtyItem, dirtyItems, item);
+
+        vector<char> copiedUsers, copiedItems, copiedCache;
+        for (int user : dirtyUsers)
+        {
+            next->userItems.writableSlot(user, copiedUsers) = make_shared<const vector<int>>(userItems[user]);
+            markDirty(staleUser, staleUsers, user);
+        }
+        for (int item : dirtyItems)
+        {
+            vector<pair<int, int>> row(coCounts[item].begin(), coCounts[item].end());
+            sort(row.begin(), row.end());
+            next->cooccurrence.writableSlot(item, copiedItems) = make_shared<const vector<pair<int, int>>>(move(row));
+            for (int user : itemUsers[item])
+                markDirty(staleUser, staleUsers, user);
+        }
+
+        size_t invalidated = 0;
+        for (int user : staleUsers)
+        {
+            auto &cached = next->cache.writableSlot(user, copiedCache);
+            invalidated += cached != nullptr;
+            cached.reset();
+            staleUser[user] = 0;
+        }
+
+        for (int user : dirtyUsers)
+            dirtyUser[user] = 0;
+        for (int item : dirtyItems)
+            dirtyItem[item] = 0;
+        dirtyUsers.clear();
+        dirtyItems.clear();
+        staleUsers.clear();
+
+        atomic_store(&onlineSnapshot, shared_ptr<const OnlineSnapshot>(move(next)));
+        return invalidated;
+    }
+
+    // Offer every row of a contiguous factor block to a min-heap holding the best topN unseen items
+    void scanFactors(int user, const float *query, const float *rows, const int *ids, size_t count,
+                     size_t topN, vector<pair<float, int>> &heap) const
+    {
+        const vector<int> &owned = userItems[user];
+        for (size_t r = 0; r < count; ++r)
+        {
+            float score = dotProduct(query, rows + r * model.stride, model.stride);
+            if (heap.size() == topN && !(score > heap.front().first))
+                continue;
+            int item = ids ? ids[r] : (int)r;
+            if (binary_search(owned.begin(), owned.end(), item))
+                continue;
+            if (heap.size() == topN)
+            {
+                pop_heap(heap.begin(), heap.end(), greater<pair<float, int>>());
+                heap.pop_back();
+            }
+            heap.push_back({score, item});
+            push_heap(heap.begin(), heap.end(), greater<pair<float, int>>());
+        }
+    }
+
+    // Co-occurrence scores of the items the user has not seen, in no particular order
+    void collectScores(int user, ScoringScratch &s, vector<pair<int, int>> &scoredItems,
+                       [[maybe_unused]] SearchStats *stats = nullptr) const
+    {
+        scoredItems.clear();
+        s.resize(numUsers, numItems);
+
+        const vector<int> &owned = userItems[user];
+        for (int item : owned)
+        {
+            s.ownedItem[item] = 1;
+            DSA_STAT(if (stats) stats->edgesRelaxed += itemUsers[item].size());
+            for (int other : itemUsers[item])
+            {
+                if (other == user)
+                    continue;
+                if (s.overlap[other]++ == 0)
+                    s.touchedUsers.push_back(other);
+            }
+        }
+
+        for (int other : s.touchedUsers)
+        {
+            DSA_STAT(if (stats) stats->edgesRelaxed += userItems[other].size());
+            for (int item : userItems[other])
+            {
+                if (s.ownedItem[item])
+                    continue;
+                if (s.itemScore[item] == 0)
+                    s.touchedItems.push_back(item);
+                s.itemScore[item] += s.overlap[other];
+            }
+            s.overlap[other] = 0;
+        }
+
+        for (int item : s.touchedItems)
+        {
+            scoredItems.push_back({item, s.itemScore[item]});
+            s.itemScore[item] = 0;
+        }
+        for (int item : owned)
+            s.ownedItem[item] = 0;
+        DSA_STAT(if (stats) stats->nodesSettled += s.touchedUsers.size());
+        s.touchedUsers.clear();
+        s.touchedItems.clear();
+    }
+
+    // Keep the best n entries, highest score first
+    template <typename Score>
+    static void selectTop(vector<pair<int, Score>> &items, size_t n)
+    {
+        auto better = [](const pair<int, Score> &a, const pair<int, Score> &b)
+        { return a.second != b.second ? a.second > b.second : a.first < b.first; };
+        n = min(n, items.size());
+        if (n < items.size())
+        {
+            nth_element(items.begin(), items.begin() + n, items.end(), better);
+            items.resize(n);
+        }
+        sort(items.begin(), items.end(), better);
+    }
+
 public:
     RecommendationSystem() : numUsers(0), numItems(0) {}
 
     // Add a user
     void addUser()
     {
+        lock_guard<mutex> lock(updateMutex);
         numUsers++;
+        userItems.emplace_back();
     }
 
     // Add an item
     void addItem()
     {
+        lock_guard<mutex> lock(updateMutex);
         numItems++;
+        itemUsers.emplace_back();
+        if (onlineEnabled)
+            coCounts.emplace_back();
     }
 
     // Add a user-item interaction
     void addInteraction(int user, int item)
     {
-        if (user >= numUsers || item >= numItems)
+        lock_guard<mutex> lock(updateMutex);
+        if (user < 0 || item < 0 || user >= numUsers || item >= numItems)
         {
             cout << "Invalid interaction! User or Item does not exist.\n";
             return;
         }
         userItemGraph[user].push_back(item);
+
+        vector<int> &items = userItems[user];
+        auto pos = lower_bound(items.begin(), items.end(), item);
+        if (pos == items.end() || *pos != item)
+        {
+            if (onlineEnabled)
+            {
+                // The new item now co-occurs once more with everything the user already holds
+                for (int other : items)
+                {
+                    coCounts[item][other]++;
+                    coCounts[other][item]++;
+                    markDirty(dirtyItem, dirtyItems, other);
+                }
+                markDirty(dirtyItem, dirtyItems, item);
+                markDirty(dirtyUser, dirtyUsers, user);
+            }
+            items.insert(pos, item);
+            itemUsers[item].push_back(user);
+        }
+    }
+
+    // Start maintaining co-occurrence counts and a published snapshot; cacheDepth bounds the cached lists
+    void enableOnlineUpdates(size_t cacheDepth = 50)
+    {
+        lock_guard<mutex> lock(updateMutex);
+        onlineEnabled = true;
+        onlineCacheDepth = cacheDepth;
+        coCounts.assign(numItems, unordered_map<int, int>());
+        for (int user = 0; user < numUsers; ++user)
+        {
+            const vector<int> &items = userItems[user];
+            for (size_t a = 0; a < items.size(); ++a)
+                for (size_t b = a + 1; b < items.size(); ++b)
+                {
+                    coCounts[items[a]][items[b]]++;
+                    coCounts[items[b]][items[a]]++;
+                }
+        }
+        atomic_store(&onlineSnapshot, shared_ptr<const OnlineSnapshot>());
+        publishLocked();
+    }
+
+    // Make interactions recorded since the last publish visible to readers; returns the number of dropped cache entries
+    size_t publishUpdates()
+    {
+        lock_guard<mutex> lock(updateMutex);
+        return onlineEnabled ? publishLocked() : 0;
+    }
+
+    // Lock-free read path: recommendations from the latest published snapshot, cached per user
+    vector<pair<int, int>> onlineRecommend(int user, size_t topN = 10) const
+    {
+        shared_ptr<const OnlineSnapshot> snapshot = atomic_load(&onlineSnapshot);
+        if (!snapshot || user < 0 || user >= snapshot->numUsers)
+            return {};
+
+        shared_ptr<const vector<pair<int, int>>> cached = atomic_load(&snapshot->cache.slot(user));
+        if (!cached)
+        {
+            // Summing co-occurrence rows of the user's items gives the same scores as recommendItems
+            const vector<int> &owned = *snapshot->userItems.slot(user);
+            unordered_map<int, int> scores;
+            for (int item : owned)
+                for (const auto &entry : *snapshot->cooccurrence.slot(item))
+                    if (!binary_search(owned.begin(), owned.end(), entry.first))
+                        scores[entry.first] += entry.second;
+
+            vector<pair<int, int>> ranked(scores.begin(), scores.end());
+            selectTop(ranked, onlineCacheDepth);
+            cached = make_shared<const vector<pair<int, int>>>(move(ranked));
+            atomic_store(&snapshot->cache.slot(user), cached);
+        }
+        return vector<pair<int, int>>(cached->begin(), cached->begin() + min(topN, cached->size()));
     }
 
     // Print user-item interactions
@@ -59,51 +551,483 @@ public:
         }
     }
 
-    // Recommend items using collaborative filtering
-    void recommendItems(int user)
+    // Top-N recommendations for every user, written as a compact binary stream:
+    // "RECS", uint32 user count, uint32 topN, then per user a uint32 count
+    // followed by that many (int32 item, int32 score) pairs.
+    bool recommendAll(size_t topN, ostream &out, int numThreads = 0) const
     {
-        if (user >= numUsers)
+        numThreads = resolveThreadCount(numThreads);
+        const int blockUsers = 1 << 16;
+        vector<ScoringScratch> scratches(numThreads);
+        vector<vector<pair<int, int>>> results(min(numUsers, blockUsers));
+
+        uint32_t header[2] = {(uint32_t)numUsers, (uint32_t)topN};
+        out.write("RECS", 4);
+        out.write((const char *)header, sizeof(header));
+
+        // Score a block of users in parallel, then append the block in user order
+        for (int begin = 0; begin < numUsers; begin += blockUsers)
         {
-            cout << "Invalid user!\n";
-            return;
+            int end = min(numUsers, begin + blockUsers);
+            parallelFor(end - begin, numThreads, [&](size_t i, int id)
+                        {
+                vector<pair<int, int>> &scored = results[i];
+                collectScores(begin + (int)i, scratches[id], scored);
+                selectTop(scored, topN); });
+
+            for (int i = 0; i < end - begin; ++i)
+            {
+                uint32_t count = results[i].size();
+                out.write((const char *)&count, sizeof(count));
+                for (const auto &entry : results[i])
+                {
+                    int32_t record[2] = {entry.first, entry.second};
+                    out.write((const char *)record, sizeof(record));
+                }
+            }
+        }
+        return (bool)out;
+    }
+
+    bool recommendAll(size_t topN, const string &path, int numThreads = 0) const
+    {
+        ofstream out(path, ios::binary);
+        if (!out)
+        {
+            cout << "Could not open " << path << " for writing!\n";
+            return false;
+        }
+        return recommendAll(topN, out, numThreads);
+    }
+
+    // Offline build of the sparse item-item similarity matrix, keeping the top k per item
+    void buildItemSimilarity(size_t k = 50, SimilarityMetric metric = SimilarityMetric::Cosine, int numThreads = 0)
+    {
+        numThreads = resolveThreadCount(numThreads);
+        vector<vector<pair<int, float>>> lists(numItems);
+        vector<vector<int>> coCount(numThreads, vector<int>(numItems, 0));
+        vector<vector<int>> touched(numThreads);
+
+        parallelFor(numItems, numThreads, [&](size_t i, int id)
+                    {
+            vector<int> &count = coCount[id];
+            for (int user : itemUsers[i])
+            {
+                for (int j : userItems[user])
+                {
+                    if (j != (int)i && count[j]++ == 0)
+                        touched[id].push_back(j);
+                }
+            }
+
+            vector<pair<int, float>> &list = lists[i];
+            double sizeI = itemUsers[i].size();
+            for (int j : touched[id])
+            {
+                double sizeJ = itemUsers[j].size();
+                double sim = metric == SimilarityMetric::Cosine ? count[j] / sqrt(sizeI * sizeJ)
+                                                                : count[j] / (sizeI + sizeJ - count[j]);
+                list.push_back({j, (float)sim});
+                count[j] = 0;
+            }
+            touched[id].clear();
+
+            auto better = [](const pair<int, float> &a, const pair<int, float> &b)
+            { return a.second != b.second ? a.second > b.second : a.first < b.first; };
+            if (list.size() > k)
+            {
+                nth_element(list.begin(), list.begin() + k, list.end(), better);
+                list.resize(k);
+            }
+            sort(list.begin(), list.end(), better); });
+
+        itemSimilarity.numItems = numItems;
+        itemSimilarity.offsets.assign(numItems + 1, 0);
+        for (int i = 0; i < numItems; ++i)
+            itemSimilarity.offsets[i + 1] = itemSimilarity.offsets[i] + lists[i].size();
+        itemSimilarity.neighbors.resize(itemSimilarity.offsets[numItems]);
+        itemSimilarity.similarity.resize(itemSimilarity.offsets[numItems]);
+        for (int i = 0; i < numItems; ++i)
+        {
+            size_t pos = itemSimilarity.offsets[i];
+            for (const auto &entry : lists[i])
+            {
+                itemSimilarity.neighbors[pos] = entry.first;
+                itemSimilarity.similarity[pos++] = entry.second;
+            }
         }
+    }
+
+    const ItemSimilarityIndex &similarityIndex() const
+    {
+        return itemSimilarity;
+    }
 
-        unordered_map<int, int> itemScores; // Item -> Score
+    // Online recommendation from the precomputed neighbours of the user's items
+    vector<pair<int, float>> recommendFromSimilarity(int user, size_t topN = 10)
+    {
+        vector<pair<int, float>> result;
+        if (user < 0 || user >= numUsers || itemSimilarity.numItems == 0)
+            return result;
+
+        similarityScore.resize(itemSimilarity.numItems, 0);
+        scratch.resize(numUsers, numItems);
+        const vector<int> &owned = userItems[user];
+        for (int item : owned)
+            scratch.ownedItem[item] = 1;
 
-        // For each item interacted by the target user, find similar users
-        for (int item : userItemGraph[user])
+        for (int item : owned)
         {
-            for (const auto &pair : userItemGraph)
+            if (item >= itemSimilarity.numItems)
+                continue;
+            for (size_t e = itemSimilarity.offsets[item]; e < itemSimilarity.offsets[item + 1]; ++e)
             {
-                if (pair.first == user)
+                int candidate = itemSimilarity.neighbors[e];
+                if (scratch.ownedItem[candidate])
                     continue;
+                if (similarityScore[candidate] == 0)
+                    scratch.touchedItems.push_back(candidate);
+                similarityScore[candidate] += itemSimilarity.similarity[e];
+            }
+        }
 
-                if (find(pair.second.begin(), pair.second.end(), item) != pair.second.end())
-                {
-                    for (int otherItem : pair.second)
-                    {
-                        if (find(userItemGraph[user].begin(), userItemGraph[user].end(), otherItem) == userItemGraph[user].end())
+        for (int item : scratch.touchedItems)
+        {
+            result.push_back({item, similarityScore[item]});
+            similarityScore[item] = 0;
+        }
+        for (int item : owned)
+            scratch.ownedItem[item] = 0;
+        scratch.touchedItems.clear();
+
+        selectTop(result, topN);
+        return result;
+    }
+
+    // Snapshot the interactions into the flat CSR used by random walks
+    void buildWalkGraph()
+    {
+        auto flatten = [](const vector<vector<int>> &lists, vector<size_t> &offsets, vector<int> &flat)
+        {
+            offsets.assign(lists.size() + 1, 0);
+            for (size_t i = 0; i < lists.size(); ++i)
+                offsets[i + 1] = offsets[i] + lists[i].size();
+            flat.resize(offsets.back());
+            for (size_t i = 0; i < lists.size(); ++i)
+                copy(lists[i].begin(), lists[i].end(), flat.begin() + offsets[i]);
+        };
+        flatten(userItems, walkGraph.userOffsets, walkGraph.userItems);
+        flatten(itemUsers, walkGraph.itemOffsets, walkGraph.itemUsers);
+    }
+
+    // Pixie-style random walk with restart from the user's items; visit counts rank the candidates
+    vector<pair<int, int>> randomWalkRecommend(int user, size_t topN = 10, const WalkConfig &config = WalkConfig())
+    {
+        vector<pair<int, int>> result;
+        if (user < 0 || user + 1 >= (int)walkGraph.userOffsets.size())
+            return result;
+
+        const BipartiteCSR &g = walkGraph;
+        size_t queryBegin = g.userOffsets[user], queryEnd = g.userOffsets[user + 1];
+        if (queryBegin == queryEnd)
+            return result;
+
+        const vector<int> &owned = userItems[user];
+        int numThreads = max(1, config.numThreads);
+        int numGraphItems = g.itemOffsets.size() - 1;
+        walkVisits.resize(numThreads);
+        vector<vector<int>> touched(numThreads);
+        int minVisits = max(1, (config.minVisits + numThreads - 1) / numThreads);
+        uint32_t restartThreshold = (uint32_t)(config.restartProbability * 4294967295.0);
+
+        auto walker = [&](int id)
+        {
+            vector<uint32_t> &visits = walkVisits[id];
+            visits.resize(numGraphItems, 0);
+            uint64_t state = config.seed ^ ((uint64_t)user * 0xbf58476d1ce4e5b9ULL) ^ ((uint64_t)(id + 1) << 32);
+            auto next = [&]()
+            {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return state;
+            };
+
+            size_t steps = config.stepBudget / numThreads;
+            size_t settled = 0;
+            int item = g.userItems[queryBegin + next() % (queryEnd - queryBegin)];
+            for (size_t step = 0; step < steps && settled < config.settledCandidates; ++step)
+            {
+                if ((uint32_t)next() < restartThreshold)
+                    item = g.userItems[queryBegin + next() % (queryEnd - queryBegin)];
+
+                size_t usersOfItem = g.itemOffsets[item + 1] - g.itemOffsets[item];
+                int other = g.itemUsers[g.itemOffsets[item] + next() % usersOfItem];
+                size_t itemsOfUser = g.userOffsets[other + 1] - g.userOffsets[other];
+                item = g.userItems[g.userOffsets[other] + next() % itemsOfUser];
+
+                if (visits[item]++ == 0)
+                    touched[id].push_back(item);
+                // Only items the user does not already hold can become recommendations
+                if (visits[item] == (uint32_t)minVisits && !binary_search(owned.begin(), owned.end(), item))
+                    settled++;
+            }
+        };
+
+        vector<thread> threads;
+        for (int id = 1; id < numThreads; ++id)
+            threads.emplace_back(walker, id);
+        walker(0);
+        for (auto &t : threads)
+            t.join();
+
+        // Merge thread counters into the first one, skipping the user's own items
+        vector<uint32_t> &total = walkVisits[0];
+        vector<int> candidates = move(touched[0]);
+        for (int id = 1; id < numThreads; ++id)
+        {
+            for (int item : touched[id])
+            {
+                if (total[item] == 0)
+                    candidates.push_back(item);
+                total[item] += walkVisits[id][item];
+                walkVisits[id][item] = 0;
+            }
+        }
+        for (int item : candidates)
+        {
+            if (!binary_search(owned.begin(), owned.end(), item))
+                result.push_back({item, (int)total[item]});
+            total[item] = 0;
+        }
+
+        selectTop(result, topN);
+        return result;
+    }
+
+    // Train user and item factors with implicit ALS; repeated interactions raise the confidence
+    void trainFactors(const ALSConfig &config = ALSConfig())
+    {
+        int k = max(1, config.factors);
+        size_t stride = (k + 7) / 8 * 8;
+        int numThreads = resolveThreadCount(config.numThreads);
+
+        // Interaction counts per (user, item), in both directions
+        vector<vector<pair<int, float>>> byUser(numUsers), byItem(numItems);
+        for (int user = 0; user < numUsers; ++user)
+        {
+            auto found = userItemGraph.find(user);
+            if (found == userItemGraph.end())
+                continue;
+            vector<int> items = found->second;
+            sort(items.begin(), items.end());
+            for (size_t i = 0; i < items.size();)
+            {
+                size_t j = i;
+                while (j < items.size() && items[j] == items[i])
+                    ++j;
+                byUser[user].push_back({items[i], (float)(j - i)});
+                byItem[items[i]].push_back({user, (float)(j - i)});
+                i = j;
+            }
+        }
+
+        model.factors = k;
+        model.stride = stride;
+        model.userFactors.assign(numUsers * stride, 0.0f);
+        model.itemFactors.assign(numItems * stride, 0.0f);
+        factorIndex = FactorIndex();
+        mt19937_64 rng(config.seed);
+        normal_distribution<float> noise(0.0f, 0.01f);
+        for (int item = 0; item < numItems; ++item)
+            for (int a = 0; a < k; ++a)
+                model.itemFactors[item * stride + a] = noise(rng);
+
+        vector<vector<double>> systems(numThreads, vector<double>(k * k)), rhs(numThreads, vector<double>(k));
+        vector<double> gram(k * k);
+
+        // One half-step: solve every row of out against the fixed factors of the other side
+        auto solveSide = [&](const vector<vector<pair<int, float>>> &ratings, const vector<float> &fixed, vector<float> &out)
+        {
+            size_t fixedRows = fixed.size() / stride;
+            parallelFor(k, numThreads, [&](size_t a, int)
                         {
-                            itemScores[otherItem]++;
-                        }
-                    }
-                }
+                            for (int b = a; b < k; ++b)
+                            {
+                                double sum = 0;
+                                for (size_t r = 0; r < fixedRows; ++r)
+                                    sum += (double)fixed[r * stride + a] * fixed[r * stride + b];
+                                gram[a * k + b] = gram[b * k + a] = sum;
+                            } }, 1);
+
+            parallelFor(ratings.size(), numThreads, [&](size_t row, int id)
+                        {
+                            vector<double> &A = systems[id];
+                            vector<double> &b = rhs[id];
+                            A = gram;
+                            fill(b.begin(), b.end(), 0.0);
+                            for (int a = 0; a < k; ++a)
+                                A[a * k + a] += config.regularization;
+                            for (const auto &entry : ratings[row])
+                            {
+                                double confidence = 1.0 + config.alpha * entry.second;
+                                const float *y = &fixed[entry.first * stride];
+                                for (int a = 0; a < k; ++a)
+                                {
+                                    b[a] += confidence * y[a];
+                                    for (int c = 0; c <= a; ++c)
+                                        A[a * k + c] += (confidence - 1.0) * y[a] * y[c];
+                                }
+                            }
+                            float *x = &out[row * stride];
+                            if (ratings[row].empty() || !choleskySolve(A, b, k))
+                                fill(x, x + k, 0.0f);
+                            else
+                                for (int a = 0; a < k; ++a)
+                                    x[a] = (float)b[a]; }, 16);
+        };
+
+        for (int iter = 0; iter < config.iterations; ++iter)
+        {
+            solveSide(byUser, model.itemFactors, model.userFactors);
+            solveSide(byItem, model.userFactors, model.itemFactors);
+        }
+    }
+
+    const FactorModel &factorModel() const
+    {
+        return model;
+    }
+
+    // Group item factors into numLists k-means clusters (0 = sqrt of the item count) for approximate search
+    void buildFactorIndex(int numLists = 0, int iterations = 5, int numThreads = 0)
+    {
+        factorIndex = FactorIndex();
+        if (model.itemFactors.empty())
+            return;
+        size_t stride = model.stride;
+        numThreads = resolveThreadCount(numThreads);
+        if (numLists <= 0)
+            numLists = max(1, (int)sqrt((double)numItems));
+        numLists = min(numLists, numItems);
+
+        vector<float> &centroids = factorIndex.centroids;
+        centroids.resize(numLists * stride);
+        for (int l = 0; l < numLists; ++l)
+        {
+            size_t seedItem = (size_t)l * numItems / numLists;
+            copy_n(&model.itemFactors[seedItem * stride], stride, &centroids[l * stride]);
+        }
+
+        // Lloyd iterations; nearest centroid minimises |c|^2 - 2 y.c
+        vector<int> assignment(numItems, 0);
+        vector<float> centroidNorm(numLists);
+        for (int iter = 0; iter <= iterations; ++iter)
+        {
+            for (int l = 0; l < numLists; ++l)
+                centroidNorm[l] = dotProduct(&centroids[l * stride], &centroids[l * stride], stride);
+            parallelFor(numItems, numThreads, [&](size_t item, int)
+                        {
+                            const float *y = &model.itemFactors[item * stride];
+                            float best = 0;
+                            for (int l = 0; l < numLists; ++l)
+                            {
+                                float d = centroidNorm[l] - 2 * dotProduct(y, &centroids[l * stride], stride);
+                                if (l == 0 || d < best)
+                                {
+                                    best = d;
+                                    assignment[item] = l;
+                                }
+                            } }, 256);
+            if (iter == iterations)
+                break;
+
+            vector<double> sums(numLists * stride, 0.0);
+            vector<int> sizes(numLists, 0);
+            for (int item = 0; item < numItems; ++item)
+            {
+                int l = assignment[item];
+                sizes[l]++;
+                for (size_t a = 0; a < stride; ++a)
+                    sums[l * stride + a] += model.itemFactors[item * stride + a];
             }
+            for (int l = 0; l < numLists; ++l)
+                if (sizes[l] > 0)
+                    for (size_t a = 0; a < stride; ++a)
+                        centroids[l * stride + a] = (float)(sums[l * stride + a] / sizes[l]);
         }
 
-        // Sort items by score
-        vector<pair<int, int>> scoredItems(itemScores.begin(), itemScores.end());
-        sort(scoredItems.begin(), scoredItems.end(), [](const pair<int, int> &a, const pair<int, int> &b)
-             { return a.second > b.second; });
+        // Counting sort of the items by list, copying their factors alongside
+        factorIndex.numLists = numLists;
+        factorIndex.listOffsets.assign(numLists + 1, 0);
+        for (int item = 0; item < numItems; ++item)
+            factorIndex.listOffsets[assignment[item] + 1]++;
+        for (int l = 0; l < numLists; ++l)
+            factorIndex.listOffsets[l + 1] += factorIndex.listOffsets[l];
+        factorIndex.listItems.resize(numItems);
+        factorIndex.listFactors.resize(numItems * stride);
+        vector<size_t> cursor(factorIndex.listOffsets.begin(), factorIndex.listOffsets.end() - 1);
+        for (int item = 0; item < numItems; ++item)
+        {
+            size_t slot = cursor[assignment[item]]++;
+            factorIndex.listItems[slot] = item;
+            copy_n(&model.itemFactors[item * stride], stride, &factorIndex.listFactors[slot * stride]);
+        }
+    }
+
+    // Top-N unseen items by factor dot product; probeLists > 0 scans only that many index lists
+    vector<pair<int, float>> recommendFromFactors(int user, size_t topN = 10, int probeLists = 0) const
+    {
+        vector<pair<int, float>> result;
+        if (user < 0 || user >= numUsers || topN == 0 || model.userFactors.empty())
+            return result;
 
-        cout << "Recommended items for user " << user << ":\n";
-        for (const auto &item : scoredItems)
+        const float *query = &model.userFactors[user * model.stride];
+        vector<pair<float, int>> heap;
+        heap.reserve(topN + 1);
+        if (probeLists <= 0 || factorIndex.numLists == 0)
+        {
+            scanFactors(user, query, model.itemFactors.data(), nullptr, numItems, topN, heap);
+        }
+        else
         {
-            cout << "Item " << item.first << " with score " << item.second << endl;
+            vector<pair<float, int>> lists(factorIndex.numLists);
+            for (int l = 0; l < factorIndex.numLists; ++l)
+                lists[l] = {dotProduct(query, &factorIndex.centroids[l * model.stride], model.stride), l};
+            size_t probes = min<size_t>(probeLists, lists.size());
+            partial_sort(lists.begin(), lists.begin() + probes, lists.end(), greater<pair<float, int>>());
+            for (size_t p = 0; p < probes; ++p)
+            {
+                size_t begin = factorIndex.listOffsets[lists[p].second];
+                size_t end = factorIndex.listOffsets[lists[p].second + 1];
+                scanFactors(user, query, &factorIndex.listFactors[begin * model.stride],
+                            &factorIndex.listItems[begin], end - begin, topN, heap);
+            }
         }
+
+        for (const auto &entry : heap)
+            result.push_back({entry.second, entry.first});
+        selectTop(result, topN);
+        return result;
+    }
+
+    // Recommend items using collaborative filtering: every co-user adds its overlap with the target to
+    // each unseen item it holds; all scored items, best first
+    RecommendationResult recommendItems(int user)
+    {
+        RecommendationResult result;
+        if (user < 0 || user >= numUsers)
+            return result;
+
+        DSA_STAT(auto startTime = chrono::steady_clock::now());
+        collectScores(user, scratch, result.items, &result.stats);
+        selectTop(result.items, result.items.size());
+        DSA_STAT(result.stats.wallMs = elapsedMs(startTime));
+        return result;
     }
 };
 
+#ifndef DSA_LAB_NO_MAIN
 int main()
 {
     RecommendationSystem rs;
@@ -132,7 +1056,63 @@ int main()
     rs.printInteractions();
 
     // Recommend items for a user
-    rs.recommendItems(0);
+    RecommendationResult recommended = rs.recommendItems(0);
+    cout << "Recommended items for user 0:\n";
+    for (const auto &item : recommended.items)
+    {
+        cout << "Item " << item.first << " with score " << item.second << endl;
+    }
+#ifdef DSA_LAB_INSTRUMENT
+    printSearchStats(recommended.stats);
+#endif
+
+    // Recommend from the precomputed item-item similarity
+    rs.buildItemSimilarity(10, SimilarityMetric::Cosine);
+    cout << "Similarity-based recommendations for user 0:\n";
+    for (const auto &item : rs.recommendFromSimilarity(0, 5))
+    {
+        cout << "Item " << item.first << " with score " << item.second << endl;
+    }
+
+    // Random-walk recommendations with a bounded step budget
+    rs.buildWalkGraph();
+    WalkConfig walk;
+    walk.stepBudget = 10000;
+    cout << "Random-walk recommendations for user 0:\n";
+    for (const auto &item : rs.randomWalkRecommend(0, 5, walk))
+    {
+        cout << "Item " << item.first << " with " << item.second << " visits" << endl;
+    }
+
+    // Embedding-based recommendations from implicit ALS factors
+    ALSConfig als;
+    als.factors = 8;
+    rs.trainFactors(als);
+    cout << "Factor-based recommendations for user 0:\n";
+    for (const auto &item : rs.recommendFromFactors(0, 2))
+    {
+        cout << "Item " << item.first << " with score " << item.second << endl;
+    }
+
+    // Online updates: new interactions only invalidate the caches of affected users
+    rs.enableOnlineUpdates(10);
+    rs.onlineRecommend(0, 2);
+    rs.onlineRecommend(1, 2);
+    rs.addInteraction(1, 3);
+    cout << "Online update invalidated " << rs.publishUpdates() << " cached lists\n";
+    cout << "Online recommendations for user 0:\n";
+    for (const auto &item : rs.onlineRecommend(0, 2))
+    {
+        cout << "Item " << item.first << " with score " << item.second << endl;
+    }
+
+    // Nightly batch of top-2 recommendations for every user
+    ostringstream batch;
+    if (rs.recommendAll(2, batch))
+    {
+        cout << "Batch recommendations: " << batch.str().size() << " bytes\n";
+    }
     system("pause");
     return 0;
 }
+#endif
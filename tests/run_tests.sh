@@ -0,0 +1,37 @@
+#!/bin/sh
+# Build and run every test program with the invariant checks enabled; exits non-zero on the first failure.
+set -e
+cd "$(dirname "$0")"
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -O2 -pthread -DDSA_LAB_CHECKS}
+mkdir -p bin
+for src in test_*.cpp; do
+    name=${src%.cpp}
+    $CXX $CXXFLAGS "$src" -o "bin/$name"
+    "bin/$name"
+done
+
+# The AVX2 kernels (triangle intersection, stream-vbyte decoding, factor dot products) are only
+# compiled with AVX2 enabled. When the CPU has it, run every test again in an AVX2 build and
+# require the social-network kernels to produce the same digest as the scalar build.
+if grep -qw avx2 /proc/cpuinfo 2>/dev/null; then
+    SIMDFLAGS=-mavx2
+    if grep -qw fma /proc/cpuinfo; then
+        SIMDFLAGS="$SIMDFLAGS -mfma"
+    fi
+    for src in test_*.cpp; do
+        name=${src%.cpp}
+        $CXX $CXXFLAGS $SIMDFLAGS "$src" -o "bin/${name}_avx2"
+        "bin/${name}_avx2"
+    done
+    bin/test_social_network --digest > bin/digest_scalar.txt
+    bin/test_social_network_avx2 --digest > bin/digest_avx2.txt
+    if ! cmp -s bin/digest_scalar.txt bin/digest_avx2.txt; then
+        echo "social_network: AVX2 results differ from the scalar build"
+        diff bin/digest_scalar.txt bin/digest_avx2.txt || true
+        exit 1
+    fi
+    echo "social_network: AVX2 and scalar kernels agree"
+else
+    echo "AVX2 not available: SIMD builds skipped"
+fi
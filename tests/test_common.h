@@ -0,0 +1,27 @@
+// Minimal check macro shared by the test programs: failures are reported and counted, not fatal
+#pragma once
+
+#include <cstdio>
+
+inline int &testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                               \
+    do                                                                                 \
+    {                                                                                  \
+        if (!(condition))                                                              \
+        {                                                                              \
+            std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailures()++;                                                          \
+        }                                                                              \
+    } while (0)
+
+// Prints a one-line summary and returns the process exit code
+inline int reportTests(const char *module)
+{
+    std::printf("%s: %s (%d failures)\n", module, testFailures() ? "FAILED" : "passed", testFailures());
+    return testFailures() ? 1 : 0;
+}
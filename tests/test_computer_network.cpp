@@ -0,0 +1,304 @@
+// Regression tests for computer_network.cpp
+//   g++ -std=c++17 -O2 -pthread -DDSA_LAB_CHECKS tests/test_computer_network.cpp -o test_computer_network
+#define DSA_LAB_NO_MAIN
+#include "../computer_network.cpp"
+#include "test_common.h"
+#include <random>
+
+// Random simple network on n devices with about density * n * (n - 1) / 2 links
+vector<tuple<int, int, int>> randomLinks(int n, double density, int maxWeight, mt19937 &rng)
+{
+    uniform_real_distribution<double> coin(0.0, 1.0);
+    uniform_int_distribution<int> weight(1, maxWeight);
+    vector<tuple<int, int, int>> links;
+    for (int u = 0; u < n; ++u)
+        for (int v = u + 1; v < n; ++v)
+            if (coin(rng) < density)
+                links.emplace_back(u, v, weight(rng));
+    return links;
+}
+
+// Both max-flow algorithms must match the cheapest source/sink cut found by enumerating every vertex subset
+void testMaxFlowMatchesBruteForceCut()
+{
+    mt19937 rng(17);
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        int n = 2 + trial % 7;
+        vector<tuple<int, int, int>> links = randomLinks(n, 0.5, 9, rng);
+        int source = rng() % n, sink = (source + 1 + rng() % (n - 1)) % n;
+
+        long long best = LLONG_MAX;
+        for (int mask = 0; mask < (1 << n); ++mask)
+        {
+            if (!(mask >> source & 1) || (mask >> sink & 1))
+                continue;
+            long long cut = 0;
+            for (const auto &link : links)
+                if ((mask >> get<0>(link) & 1) != (mask >> get<1>(link) & 1))
+                    cut += get<2>(link);
+            best = min(best, cut);
+        }
+
+        MaxFlowEngine engine(n, links);
+        for (auto algorithm : {MaxFlowEngine::Algorithm::Dinic, MaxFlowEngine::Algorithm::PushRelabel})
+        {
+            MaxFlowEngine::Result result = engine.maxFlow(source, sink, algorithm);
+            CHECK(result.flow == best);
+
+            // The reported cut links carry exactly the flow and separate source from sink
+            long long cutCapacity = 0;
+            vector<vector<int>> remaining(n);
+            for (const auto &link : links)
+            {
+                pair<int, int> ends = {get<0>(link), get<1>(link)};
+                if (find(result.cutLinks.begin(), result.cutLinks.end(), ends) != result.cutLinks.end())
+                {
+                    cutCapacity += get<2>(link);
+                    continue;
+                }
+                remaining[ends.first].push_back(ends.second);
+                remaining[ends.second].push_back(ends.first);
+            }
+            CHECK(cutCapacity == best);
+            vector<char> seen(n, 0);
+            vector<int> stack = {source};
+            seen[source] = 1;
+            while (!stack.empty())
+            {
+                int u = stack.back();
+                stack.pop_back();
+                for (int v : remaining[u])
+                    if (!seen[v])
+                    {
+                        seen[v] = 1;
+                        stack.push_back(v);
+                    }
+            }
+            CHECK(!seen[sink]);
+
+            vector<MaxFlowEngine::Result> batch = engine.maxFlowBatch({{source, sink}, {sink, source}}, algorithm, 2);
+            CHECK(batch[0].flow == best && batch[1].flow == best);
+        }
+    }
+}
+
+int findRoot(vector<int> &dsu, int x)
+{
+    while (dsu[x] != x)
+        x = dsu[x] = dsu[dsu[x]];
+    return x;
+}
+
+// What-if answers must match a full rebuild: Kruskal over the surviving links, and
+// partitions read off the surviving connectivity inside each intact component
+void testFailureSimulatorMatchesRebuild()
+{
+    mt19937 rng(23);
+    for (int trial = 0; trial < 150; ++trial)
+    {
+        int n = 4 + trial % 12;
+        vector<tuple<int, int, int>> links = randomLinks(n, trial % 2 ? 0.25 : 0.5, 20, rng);
+        if (links.empty())
+            continue;
+        for (int extra = 0; extra < 2; ++extra) // Parallel links must fail together
+        {
+            auto link = links[rng() % links.size()];
+            links.emplace_back(get<0>(link), get<1>(link), 1 + rng() % 20);
+        }
+        FailureSimulator simulator(n, links);
+
+        vector<int> intact(n);
+        for (int v = 0; v < n; ++v)
+            intact[v] = v;
+        for (const auto &link : links)
+            intact[findRoot(intact, get<0>(link))] = findRoot(intact, get<1>(link));
+
+        vector<FailureSimulator::Scenario> scenarios(20);
+        for (auto &scenario : scenarios)
+        {
+            for (int k = rng() % 4; k > 0; --k)
+            {
+                auto link = links[rng() % links.size()];
+                scenario.failedLinks.push_back(rng() % 2 ? make_pair(get<0>(link), get<1>(link))
+                                                         : make_pair(get<1>(link), get<0>(link)));
+            }
+            for (int k = rng() % 3; k > 0; --k)
+                scenario.failedDevices.push_back(rng() % n);
+        }
+        scenarios.push_back({}); // Nothing fails
+        vector<FailureSimulator::Result> results = simulator.simulate(scenarios, 2);
+
+        long long baseCost = 0;
+        for (size_t i = 0; i < scenarios.size(); ++i)
+        {
+            const auto &scenario = scenarios[i];
+            vector<char> failed(n, 0);
+            for (int d : scenario.failedDevices)
+                failed[d] = 1;
+            vector<tuple<int, int, int>> surviving;
+            for (const auto &link : links)
+            {
+                int u = get<0>(link), v = get<1>(link);
+                bool down = failed[u] || failed[v];
+                for (const auto &f : scenario.failedLinks)
+                    down = down || make_pair(min(u, v), max(u, v)) == make_pair(min(f.first, f.second), max(f.first, f.second));
+                if (!down)
+                    surviving.push_back(link);
+            }
+            sort(surviving.begin(), surviving.end(), [](const auto &a, const auto &b)
+                 { return get<2>(a) < get<2>(b); });
+            vector<int> dsu(n);
+            for (int v = 0; v < n; ++v)
+                dsu[v] = v;
+            long long cost = 0;
+            for (const auto &link : surviving)
+            {
+                int a = findRoot(dsu, get<0>(link)), b = findRoot(dsu, get<1>(link));
+                if (a != b)
+                {
+                    dsu[a] = b;
+                    cost += get<2>(link);
+                }
+            }
+            if (scenario.failedLinks.empty() && scenario.failedDevices.empty())
+                baseCost = cost;
+            CHECK(results[i].spanningCost == cost);
+
+            // Exactly one largest surviving group per intact component stays connected
+            map<int, int> groupSize;
+            for (int v = 0; v < n; ++v)
+                if (!failed[v])
+                    groupSize[findRoot(dsu, v)]++;
+            map<int, int> largest;
+            for (int v = 0; v < n; ++v)
+                if (!failed[v])
+                    largest[findRoot(intact, v)] = max(largest[findRoot(intact, v)], groupSize[findRoot(dsu, v)]);
+            const vector<int> &partitioned = results[i].partitionedDevices;
+            CHECK(is_sorted(partitioned.begin(), partitioned.end()));
+            map<int, set<int>> keptGroups;
+            for (int v = 0; v < n; ++v)
+            {
+                bool isPartitioned = binary_search(partitioned.begin(), partitioned.end(), v);
+                if (failed[v])
+                {
+                    CHECK(!isPartitioned);
+                    continue;
+                }
+                if (!isPartitioned)
+                {
+                    keptGroups[findRoot(intact, v)].insert(findRoot(dsu, v));
+                    CHECK(groupSize[findRoot(dsu, v)] == largest[findRoot(intact, v)]);
+                }
+            }
+            for (const auto &component : largest)
+                CHECK(keptGroups[component.first].size() == 1);
+        }
+        for (const auto &result : results)
+            CHECK(result.costIncrease == result.spanningCost - baseCost);
+    }
+}
+
+// Devices cut off from device 0 are reported instead of dropped from the spanning tree
+void testSpanningTreeReportsUnreachable()
+{
+    NetworkGraph network;
+    for (int i = 0; i < 6; ++i)
+        network.addDevice();
+    network.addConnection(0, 1, 4);
+    network.addConnection(1, 2, 1);
+    network.addConnection(0, 2, 3);
+    network.addConnection(4, 5, 6);
+
+    SpanningTreeResult tree = network.optimizeTopology();
+    CHECK(tree.links.size() == 2);
+    CHECK(tree.totalWeight == 4);
+    CHECK((tree.unreachable == vector<int>{3, 4, 5}));
+}
+
+// Tables repaired through failLink, restoreLink and updateLinkWeight must match tables built from scratch
+void testRoutingRepairMatchesRebuild()
+{
+    const int n = 30;
+    mt19937 rng(5);
+    uniform_int_distribution<int> pickNode(0, n - 1), pickWeight(1, 20);
+    map<pair<int, int>, pair<int, bool>> links; // (u, v) with u < v -> (weight, up)
+    vector<tuple<int, int, int>> initial;
+    while (initial.size() < 60)
+    {
+        int u = pickNode(rng), v = pickNode(rng);
+        if (u == v || links.count({min(u, v), max(u, v)}))
+            continue;
+        int w = pickWeight(rng);
+        links[{min(u, v), max(u, v)}] = {w, true};
+        initial.emplace_back(u, v, w);
+    }
+    RoutingTables routes(n, initial, 2);
+
+    for (int step = 0; step < 150; ++step)
+    {
+        vector<int> before;
+        for (int s = 0; s < n; ++s)
+            for (int d = 0; d < n; ++d)
+                before.push_back(routes.getDistance(s, d));
+        long long recomputed = 0;
+
+        auto it = links.begin();
+        advance(it, rng() % links.size());
+        int u = it->first.first, v = it->first.second, w = pickWeight(rng);
+        if (!it->second.second)
+        {
+            recomputed = routes.restoreLink(v, u, w);
+            it->second = {w, true};
+        }
+        else if (step % 3 == 0)
+        {
+            CHECK(routes.restoreLink(u, v, w) == -1); // Still up
+            recomputed = routes.failLink(u, v);
+            it->second.second = false;
+        }
+        else
+        {
+            recomputed = routes.updateLinkWeight(u, v, w);
+            it->second.first = w;
+        }
+        CHECK(routes.restoreLink(0, 0, 1) == -1);
+
+        vector<tuple<int, int, int>> current;
+        for (const auto &link : links)
+            if (link.second.second)
+                current.emplace_back(link.first.first, link.first.second, link.second.first);
+        RoutingTables rebuilt(n, current, 1);
+
+        // Every entry whose distance moved must have been recomputed
+        long long changed = 0;
+        for (int s = 0; s < n; ++s)
+            for (int d = 0; d < n; ++d)
+                changed += routes.getDistance(s, d) != before[s * n + d];
+        CHECK(recomputed >= changed);
+
+        for (int s = 0; s < n; ++s)
+            for (int d = 0; d < n; ++d)
+            {
+                CHECK(routes.getDistance(s, d) == rebuilt.getDistance(s, d));
+                int hop = routes.getNextHop(s, d);
+                if (s == d || rebuilt.getDistance(s, d) == INT_MAX)
+                {
+                    CHECK(hop == (s == d ? s : -1));
+                    continue;
+                }
+                auto link = links.find({min(s, hop), max(s, hop)});
+                CHECK(link != links.end() && link->second.second &&
+                      link->second.first + rebuilt.getDistance(hop, d) == rebuilt.getDistance(s, d));
+            }
+    }
+}
+
+int main()
+{
+    testMaxFlowMatchesBruteForceCut();
+    testFailureSimulatorMatchesRebuild();
+    testSpanningTreeReportsUnreachable();
+    testRoutingRepairMatchesRebuild();
+    return reportTests("computer_network");
+}
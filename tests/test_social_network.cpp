@@ -0,0 +1,440 @@
+// Regression tests for social_network.cpp. Build with the invariant checks enabled:
+//   g++ -std=c++17 -O2 -pthread -DDSA_LAB_CHECKS tests/test_social_network.cpp -o test_social_network
+// With --digest it instead prints the outputs of the SIMD-backed kernels, so run_tests.sh can
+// require a scalar and an AVX2 build to agree byte for byte.
+#define DSA_LAB_NO_MAIN
+#include "../social_network.cpp"
+#include "../benchmark/bench_common.h"
+#include "test_common.h"
+
+// Component labels of every graph form must induce the same partition as a plain BFS
+void testComponentsMatchBFS()
+{
+    for (int scaleLog2 : {6, 10, 13})
+    {
+        vector<pair<int, int>> edges;
+        for (const auto &e : generateRMAT(scaleLog2, scaleLog2 == 6 ? 1 : 2, 31 + scaleLog2))
+            edges.push_back({e.u, e.v});
+        int n = 1 << scaleLog2;
+        CSRGraph csr = BulkEdgeLoader::build(edges, n, 2);
+        CompressedGraph compressed = CompressedGraph::fromCSR(csr, 2);
+
+        vector<int> bfsLabel(n, -1);
+        vector<int> bfsSizes;
+        for (int s = 0; s < n; ++s)
+        {
+            if (bfsLabel[s] >= 0)
+                continue;
+            bfsLabel[s] = bfsSizes.size();
+            bfsSizes.push_back(0);
+            queue<int> q;
+            q.push(s);
+            while (!q.empty())
+            {
+                int u = q.front();
+                q.pop();
+                bfsSizes.back()++;
+                csr.forEachNeighbor(u, [&](int v)
+                                    {
+                    if (bfsLabel[v] < 0)
+                    {
+                        bfsLabel[v] = bfsLabel[s];
+                        q.push(v);
+                    }
+                    return true; });
+            }
+        }
+
+        auto matches = [&](const ComponentResult &result)
+        {
+            CHECK(result.numComponents == (int)bfsSizes.size());
+            CHECK((int)result.label.size() == n);
+            vector<int> mapping(bfsSizes.size(), -1);
+            for (int v = 0; v < n; ++v)
+            {
+                int &mapped = mapping[bfsLabel[v]];
+                if (mapped < 0)
+                    mapped = result.label[v];
+                CHECK(mapped == result.label[v]);
+            }
+            for (size_t c = 0; c < bfsSizes.size(); ++c)
+                CHECK(result.componentSizes[mapping[c]] == bfsSizes[c]);
+            CHECK(result.componentSizes[result.largestComponent] == *max_element(bfsSizes.begin(), bfsSizes.end()));
+            CHECK(result.singletons == (int)count(bfsSizes.begin(), bfsSizes.end(), 1));
+        };
+        for (int threads : {1, 2, 4})
+        {
+            matches(ParallelComponents<CSRGraph>(csr, threads).run());
+            matches(ParallelComponents<CompressedGraph>(compressed, threads).run());
+        }
+    }
+}
+
+// Per-vertex triangle counts and clustering must match an O(n^3) count over the adjacency matrix.
+// The CSR is built by hand with repeated entries and self-loops, which the counter has to ignore.
+void testTrianglesMatchCubicCount()
+{
+    mt19937 rng(41);
+    for (int trial = 0; trial < 6; ++trial)
+    {
+        int n = 40 + 30 * trial;
+        double density = trial % 2 ? 0.35 : 0.08; // Dense lists exercise the 8-wide blocks
+        vector<vector<char>> adjacent(n, vector<char>(n, 0));
+        vector<vector<int>> lists(n);
+        uniform_real_distribution<double> coin(0.0, 1.0);
+        for (int u = 0; u < n; ++u)
+            for (int v = u + 1; v < n; ++v)
+                if (coin(rng) < density)
+                {
+                    adjacent[u][v] = adjacent[v][u] = 1;
+                    int copies = coin(rng) < 0.1 ? 2 : 1;
+                    for (int c = 0; c < copies; ++c)
+                    {
+                        lists[u].push_back(v);
+                        lists[v].push_back(u);
+                    }
+                }
+        for (int v = 0; v < n; v += 7)
+            lists[v].push_back(v);
+
+        CSRGraph csr;
+        csr.numVertices = n;
+        csr.offsets.assign(n + 1, 0);
+        for (int v = 0; v < n; ++v)
+        {
+            shuffle(lists[v].begin(), lists[v].end(), rng);
+            csr.offsets[v + 1] = csr.offsets[v] + lists[v].size();
+            csr.neighbors.insert(csr.neighbors.end(), lists[v].begin(), lists[v].end());
+        }
+
+        vector<uint64_t> expected(n, 0);
+        uint64_t expectedTotal = 0;
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+                if (adjacent[a][b])
+                    for (int c = b + 1; c < n; ++c)
+                        if (adjacent[a][c] && adjacent[b][c])
+                        {
+                            expected[a]++;
+                            expected[b]++;
+                            expected[c]++;
+                            expectedTotal++;
+                        }
+
+        for (int threads : {1, 3})
+        {
+            TriangleResult result = TriangleCounter(threads).run(csr);
+            CHECK(result.totalTriangles == expectedTotal);
+            CHECK(result.triangles == expected);
+            double clusteringSum = 0;
+            for (int v = 0; v < n; ++v)
+            {
+                double d = count(adjacent[v].begin(), adjacent[v].end(), 1);
+                double clustering = d > 1 ? 2.0 * expected[v] / (d * (d - 1)) : 0.0;
+                CHECK(fabs(result.clustering[v] - clustering) < 1e-12);
+                clusteringSum += clustering;
+            }
+            CHECK(fabs(result.averageClustering - clusteringSum / n) < 1e-12);
+        }
+    }
+}
+
+// k-hop candidates, hop counts and shared-connection scores must match a plain BFS; one query
+// object serves every user so epoch reuse is covered, and hub-heavy graphs force bottom-up steps
+template <typename GraphT>
+void checkKHopAgainstBFS(const CSRGraph &csr, const GraphT &graph, int maxHops, size_t limit)
+{
+    int n = csr.numVertices;
+    KHopQuery<GraphT> query(graph);
+    vector<int> dist(n);
+    for (int user = 0; user < n; ++user)
+    {
+        fill(dist.begin(), dist.end(), -1);
+        dist[user] = 0;
+        vector<int> bfsOrder = {user};
+        for (size_t head = 0; head < bfsOrder.size(); ++head)
+        {
+            int u = bfsOrder[head];
+            if (dist[u] == maxHops)
+                continue;
+            csr.forEachNeighbor(u, [&](int v)
+                                {
+                if (dist[v] < 0)
+                {
+                    dist[v] = dist[u] + 1;
+                    bfsOrder.push_back(v);
+                }
+                return true; });
+        }
+
+        vector<FriendCandidate> expected;
+        for (int v : bfsOrder)
+        {
+            if (dist[v] < 2)
+                continue;
+            int shared = 0;
+            csr.forEachNeighbor(v, [&](int u)
+                                { shared += dist[u] == dist[v] - 1; return true; });
+            expected.push_back({v, dist[v], shared});
+        }
+        sort(expected.begin(), expected.end(), [](const FriendCandidate &a, const FriendCandidate &b)
+             { return a.hops != b.hops ? a.hops < b.hops : a.mutualFriends != b.mutualFriends ? a.mutualFriends > b.mutualFriends : a.user < b.user; });
+        expected.resize(min(limit, expected.size()));
+
+        vector<FriendCandidate> actual = query.query(user, maxHops, limit);
+        CHECK(actual.size() == expected.size());
+        for (size_t i = 0; i < min(actual.size(), expected.size()); ++i)
+            CHECK(actual[i].user == expected[i].user && actual[i].hops == expected[i].hops &&
+                  actual[i].mutualFriends == expected[i].mutualFriends);
+    }
+}
+
+void testKHopMatchesBFS()
+{
+    for (int edgeFactor : {1, 16})
+    {
+        vector<pair<int, int>> edges;
+        for (const auto &e : generateRMAT(10, edgeFactor, 53 + edgeFactor))
+            edges.push_back({e.u, e.v});
+        CSRGraph csr = BulkEdgeLoader::build(edges, 1 << 10, 2);
+        CompressedGraph compressed = CompressedGraph::fromCSR(csr, 2);
+        for (int maxHops : {2, 3})
+        {
+            checkKHopAgainstBFS(csr, csr, maxHops, 25);
+            checkKHopAgainstBFS(csr, compressed, maxHops, 1 << 10);
+        }
+    }
+}
+
+// Repeated addEdge calls must not inflate degrees or mutual-friend counts
+void testDuplicateFriendshipsCountOnce()
+{
+    Graph g;
+    for (int i = 0; i < 5; ++i)
+        g.addVertex();
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        g.addEdge(0, 1);
+        g.addEdge(1, 2);
+        g.addEdge(3, 1);
+        g.addEdge(3, 2);
+    }
+    g.addEdge(4, 4);
+    g.addEdge(0, 3);
+
+    CSRGraph csr = g.buildCSR(2);
+    CHECK(csr.numEdges() == 10);
+    CHECK(csr.degree(1) == 3 && csr.degree(4) == 0);
+
+    KHopQuery<CSRGraph> query(csr);
+    vector<FriendCandidate> candidates = query.query(0);
+    CHECK(candidates.size() == 1);
+    CHECK(!candidates.empty() && candidates[0].user == 2 && candidates[0].hops == 2 && candidates[0].mutualFriends == 2);
+    CHECK((g.degreeCentrality() == vector<pair<int, int>>{{1, 3}, {3, 3}, {0, 2}, {2, 2}}));
+}
+
+// Louvain with several threads; checkEmptyPools aborts if a pooled community is occupied after a batch
+void testLouvainEmptyPools()
+{
+    for (int scaleLog2 : {12, 15})
+    {
+        Graph g;
+        vector<pair<int, int>> edges;
+        for (const auto &e : generateRMAT(scaleLog2, 8, 7 + scaleLog2))
+            edges.push_back({e.u, e.v});
+        g.bulkLoad(edges, 1 << scaleLog2);
+        double serialModularity = g.detectModularityCommunities(1).modularity;
+        for (int threads : {2, 4})
+        {
+            CommunityResult result = g.detectModularityCommunities(threads);
+            CHECK((int)result.community.size() == (1 << scaleLog2));
+            CHECK(fabs(result.modularity - serialModularity) < 0.02);
+            for (int c : result.community)
+                CHECK(c >= 0 && c < result.numCommunities);
+        }
+    }
+}
+
+// Compressed lists must decode to the sorted CSR lists, including partial groups, early stops and 4-byte gaps
+void testCompressedMatchesCSR()
+{
+    const int n = 1 << 20;
+    vector<pair<int, int>> edges;
+    for (const auto &e : generateRMAT(14, 8, 3))
+        edges.push_back({e.u, e.v});
+    for (int i = 1; i <= 37; ++i)
+        edges.push_back({n - 1, i * 28000}); // Gaps above 2^8 and 2^16 from a high-id hub
+    edges.push_back({0, n - 2});             // First-neighbor offset needing all four bytes
+    CSRGraph csr = BulkEdgeLoader::build(edges, n, 2, nullptr);
+    CompressedGraph compressed = CompressedGraph::fromCSR(csr, 2);
+    CHECK(compressed.numEdges() == csr.numEdges());
+    CHECK(compressed.memoryBytes() < csr.memoryBytes());
+
+    for (int v = 0; v < n; ++v)
+    {
+        vector<int> expected(csr.neighbors.begin() + csr.offsets[v], csr.neighbors.begin() + csr.offsets[v + 1]);
+        sort(expected.begin(), expected.end());
+        CHECK(compressed.degree(v) == expected.size());
+
+        vector<int> visited, iterated, prefix;
+        compressed.forEachNeighbor(v, [&](int u)
+                                   { visited.push_back(u); return true; });
+        for (int u : compressed.neighborsOf(v))
+            iterated.push_back(u);
+        compressed.forEachNeighbor(v, [&](int u)
+                                   { prefix.push_back(u); return prefix.size() < 3; });
+        CHECK(visited == expected);
+        CHECK(iterated == expected);
+        CHECK(prefix == vector<int>(expected.begin(), expected.begin() + min<size_t>(3, expected.size())));
+    }
+
+    Graph g;
+    g.bulkLoad(edges, n);
+    vector<pair<int, int>> centrality = g.degreeCentrality(2);
+    int connected = 0;
+    for (int v = 0; v < n; ++v)
+        connected += csr.degree(v) > 0;
+    CHECK((int)centrality.size() == connected);
+    CHECK(find(centrality.begin(), centrality.end(), make_pair(n - 1, 37)) != centrality.end());
+
+    // The snapshot is reused until an edit, then re-encoded
+    const uint8_t *encoded = g.compressedSnapshot().bytes.data();
+    CHECK(g.degreeCentrality() == centrality && g.compressedSnapshot().bytes.data() == encoded);
+    g.addEdge(n - 1, 1);
+    CHECK(g.compressedSnapshot().degree(n - 1) == 38);
+    vector<pair<int, int>> updated = g.degreeCentrality();
+    CHECK(find(updated.begin(), updated.end(), make_pair(n - 1, 38)) != updated.end());
+    for (size_t i = 0; i < centrality.size(); ++i)
+    {
+        CHECK(centrality[i].second == (int)csr.degree(centrality[i].first) && centrality[i].second > 0);
+        if (i > 0)
+            CHECK(centrality[i - 1].second > centrality[i].second ||
+                  (centrality[i - 1].second == centrality[i].second && centrality[i - 1].first < centrality[i].first));
+    }
+}
+
+// After every event the heap must hold the exact top-k by (degree desc, id asc), ties at the cutoff included
+void testStreamingTopKTies()
+{
+    const int n = 40;
+    const size_t k = 5;
+    StreamingGraphStats stats(k);
+    vector<int> degrees(n, 0);
+    mt19937 rng(11);
+    uniform_int_distribution<int> pick(0, n - 1);
+    for (int event = 0; event < 3000; ++event)
+    {
+        int u = pick(rng), v = pick(rng);
+        if (stats.addEdge(u, v))
+        {
+            degrees[u]++;
+            degrees[v]++;
+        }
+
+        vector<pair<int, int>> expected;
+        for (int w = 0; w < n; ++w)
+            if (degrees[w] > 0)
+                expected.emplace_back(w, degrees[w]);
+        sort(expected.begin(), expected.end(), [](const auto &a, const auto &b)
+             { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+        expected.resize(min(k, expected.size()));
+        CHECK(stats.topK() == expected);
+    }
+
+    // A later vertex tying the cutoff with a lower id displaces the higher id
+    StreamingGraphStats ties(1);
+    ties.addEdge(9, 8);
+    ties.addEdge(3, 2);
+    CHECK((ties.topK() == vector<pair<int, int>>{{2, 1}}));
+}
+
+vector<pair<int, int>> parse(const string &text, int numThreads = 1)
+{
+    return BulkEdgeLoader::parseEdgeList(text.data(), text.size(), numThreads);
+}
+
+// Only lines with two plain non-negative ids below INT_MAX become edges
+void testEdgeListParser()
+{
+    using Edges = vector<pair<int, int>>;
+    CHECK((parse("0 1\n2\t3\r\n  4 5 0.25\n") == Edges{{0, 1}, {2, 3}, {4, 5}}));
+    CHECK((parse("# comment 1 2\n% header 3 4\n\n6 7") == Edges{{6, 7}}));
+    CHECK((parse("-1 5\n1 -5\n1x2 3\n1 2x\n7\n+1 2\n8 9\n") == Edges{{8, 9}}));
+    CHECK((parse("2147483646 0\n2147483647 0\n2147483648 0\n0 99999999999999999999999\n3 4\n") ==
+           Edges{{INT_MAX - 1, 0}, {3, 4}}));
+
+    // Chunked parsing must agree with a single pass whatever the split points
+    string text;
+    size_t wellFormed = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        text += to_string(i) + (i % 7 == 0 ? " -" : " ") + to_string(i * 31 % 1000) + (i % 11 == 0 ? "x\n" : "\n");
+        wellFormed += i % 7 != 0 && i % 11 != 0;
+    }
+    Edges serial = parse(text);
+    CHECK(serial.size() == wellFormed);
+    for (int threads : {2, 3, 8})
+        CHECK(parse(text, threads) == serial);
+}
+
+// Ids of INT_MAX cannot size the graph: build() must count them as invalid rather than overflow
+void testBulkLoadRejectsIntMaxIds()
+{
+    string text = "0 1\n2147483647 0\n3 4\n";
+    vector<pair<int, int>> parsed = parse(text);
+    CHECK((parsed == vector<pair<int, int>>{{0, 1}, {3, 4}}));
+
+    vector<pair<int, int>> edges = {{0, 1}, {INT_MAX, 0}, {3, 4}, {2, INT_MAX}};
+    BulkLoadStats stats;
+    CSRGraph csr = BulkEdgeLoader::build(edges, -1, 2, &stats);
+    CHECK(csr.numVertices == 5);
+    CHECK(csr.numEdges() == 4);
+    CHECK(stats.invalidEdges == 2);
+    CHECK(stats.inputEdges == 4);
+    CHECK(BulkEdgeLoader::build(parsed, -1, 1).numEdges() == 4);
+}
+
+// Triangle counts and decoded neighbour streams of a hub-heavy graph, one line per kernel
+void printSimdDigest()
+{
+    vector<pair<int, int>> edges;
+    for (const auto &e : generateRMAT(13, 16, 61))
+        edges.push_back({e.u, e.v});
+    CSRGraph csr = BulkEdgeLoader::build(edges, 1 << 13, 1);
+    CompressedGraph compressed = CompressedGraph::fromCSR(csr, 1);
+
+    TriangleResult triangles = TriangleCounter(2).run(csr);
+    uint64_t hash = 0;
+    for (uint64_t t : triangles.triangles)
+        hash = hash * 1000003 + t;
+    printf("triangles %llu %016llx\n", (unsigned long long)triangles.totalTriangles, (unsigned long long)hash);
+
+    uint64_t visited = 0, iterated = 0;
+    for (int v = 0; v < compressed.numVertices; ++v)
+    {
+        compressed.forEachNeighbor(v, [&](int u)
+                                   { visited = visited * 31 + u; return true; });
+        for (int u : compressed.neighborsOf(v))
+            iterated = iterated * 31 + u;
+    }
+    printf("decode %016llx %016llx\n", (unsigned long long)visited, (unsigned long long)iterated);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "--digest"))
+    {
+        printSimdDigest();
+        return 0;
+    }
+    testComponentsMatchBFS();
+    testTrianglesMatchCubicCount();
+    testKHopMatchesBFS();
+    testDuplicateFriendshipsCountOnce();
+    testLouvainEmptyPools();
+    testCompressedMatchesCSR();
+    testStreamingTopKTies();
+    testEdgeListParser();
+    testBulkLoadRejectsIntMaxIds();
+    return reportTests("social_network");
+}
@@ -0,0 +1,301 @@
+// Regression tests for system_recommend.cpp
+//   g++ -std=c++17 -O2 -pthread -DDSA_LAB_CHECKS tests/test_system_recommend.cpp -o test_system_recommend
+#define DSA_LAB_NO_MAIN
+#include "../system_recommend.cpp"
+#include "test_common.h"
+
+// Builds users x items with the given interactions
+void fill(RecommendationSystem &rs, int users, int items, const vector<pair<int, int>> &interactions)
+{
+    for (int u = 0; u < users; ++u)
+        rs.addUser();
+    for (int i = 0; i < items; ++i)
+        rs.addItem();
+    for (const auto &interaction : interactions)
+        rs.addInteraction(interaction.first, interaction.second);
+}
+
+// Top-k neighbour lists must match similarities computed directly from the user sets of each item pair,
+// and similarity recommendations must add up those lists over the user's items
+void testItemSimilarityMatchesDirect()
+{
+    const int users = 300, items = 120;
+    mt19937 rng(29);
+    vector<pair<int, int>> interactions;
+    vector<set<int>> usersOf(items), itemsOf(users);
+    for (int e = 0; e < 2500; ++e)
+    {
+        int user = rng() % users, item = (rng() % items) * (rng() % items) / items; // Skewed popularity
+        interactions.push_back({user, item});
+        usersOf[item].insert(user);
+        itemsOf[user].insert(item);
+    }
+    RecommendationSystem rs;
+    fill(rs, users, items, interactions);
+
+    for (auto metric : {SimilarityMetric::Cosine, SimilarityMetric::Jaccard})
+        for (size_t k : {5, 1000})
+        {
+            rs.buildItemSimilarity(k, metric, 3);
+            const ItemSimilarityIndex &index = rs.similarityIndex();
+            CHECK(index.numItems == items);
+
+            vector<vector<pair<int, float>>> expected(items);
+            for (int i = 0; i < items; ++i)
+            {
+                for (int j = 0; j < items; ++j)
+                {
+                    if (j == i)
+                        continue;
+                    double common = 0;
+                    for (int user : usersOf[i])
+                        common += usersOf[j].count(user);
+                    if (common == 0)
+                        continue;
+                    double sizeI = usersOf[i].size(), sizeJ = usersOf[j].size();
+                    double sim = metric == SimilarityMetric::Cosine ? common / sqrt(sizeI * sizeJ)
+                                                                    : common / (sizeI + sizeJ - common);
+                    expected[i].push_back({j, (float)sim});
+                }
+                sort(expected[i].begin(), expected[i].end(), [](const auto &a, const auto &b)
+                     { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+                expected[i].resize(min(k, expected[i].size()));
+
+                vector<pair<int, float>> actual;
+                for (size_t e = index.offsets[i]; e < index.offsets[i + 1]; ++e)
+                    actual.push_back({index.neighbors[e], index.similarity[e]});
+                CHECK(actual == expected[i]);
+            }
+
+            for (int user = 0; user < users; user += 7)
+            {
+                map<int, double> score;
+                for (int item : itemsOf[user])
+                    for (const auto &entry : expected[item])
+                        if (!itemsOf[user].count(entry.first))
+                            score[entry.first] += entry.second;
+                vector<pair<int, float>> recommended = rs.recommendFromSimilarity(user, items);
+                CHECK(recommended.size() == score.size());
+                for (const auto &entry : recommended)
+                    CHECK(score.count(entry.first) && fabs(entry.second - score[entry.first]) < 1e-4);
+            }
+        }
+}
+
+// recommendAll's binary stream, read back, must hold each user's single-user top-N; more than one
+// 65536-user block is written, and the bytes must not depend on the thread count or the sink
+void testRecommendAllRoundTrip()
+{
+    const int users = 70000, items = 20000;
+    const size_t topN = 5;
+    mt19937 rng(37);
+    vector<pair<int, int>> interactions;
+    for (int e = 0; e < 3 * users; ++e)
+        interactions.push_back({(int)(rng() % users), (int)(rng() % items)});
+    RecommendationSystem rs;
+    fill(rs, users, items, interactions);
+
+    ostringstream serial, parallel;
+    CHECK(rs.recommendAll(topN, serial, 1));
+    CHECK(rs.recommendAll(topN, parallel, 3));
+    CHECK(serial.str() == parallel.str());
+
+    string path = "recommend_all_test.bin";
+    CHECK(rs.recommendAll(topN, path, 2));
+    ifstream file(path, ios::binary);
+    CHECK(string(istreambuf_iterator<char>(file), istreambuf_iterator<char>()) == serial.str());
+    remove(path.c_str());
+
+    istringstream in(serial.str());
+    char magic[4];
+    uint32_t header[2];
+    in.read(magic, 4);
+    in.read((char *)header, sizeof(header));
+    CHECK(string(magic, 4) == "RECS" && header[0] == (uint32_t)users && header[1] == topN);
+    int fullLists = 0;
+    for (int user = 0; user < users && in; ++user)
+    {
+        uint32_t count = 0;
+        in.read((char *)&count, sizeof(count));
+        vector<pair<int, int>> stored(count);
+        fullLists += count == topN;
+        for (auto &entry : stored)
+        {
+            int32_t record[2];
+            in.read((char *)record, sizeof(record));
+            entry = {record[0], record[1]};
+        }
+        if (user % 97 == 0 || user >= users - 3)
+        {
+            vector<pair<int, int>> expected = rs.recommendItems(user).items;
+            expected.resize(min(topN, expected.size()));
+            CHECK(stored == expected);
+        }
+    }
+    CHECK(in.peek() == EOF);
+    CHECK(fullLists > users / 2);
+}
+
+// Exact top-N of unseen items by a plain dot product over the trained factors
+vector<pair<int, float>> exactFactorTopN(const FactorModel &model, const vector<set<int>> &itemsOf, int user, size_t topN)
+{
+    int items = model.itemFactors.size() / model.stride;
+    vector<pair<int, float>> scored;
+    for (int item = 0; item < items; ++item)
+    {
+        if (itemsOf[user].count(item))
+            continue;
+        double dot = 0;
+        for (int a = 0; a < model.factors; ++a)
+            dot += (double)model.userFactors[user * model.stride + a] * model.itemFactors[item * model.stride + a];
+        scored.push_back({item, (float)dot});
+    }
+    sort(scored.begin(), scored.end(), [](const auto &a, const auto &b)
+         { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+    scored.resize(min(topN, scored.size()));
+    return scored;
+}
+
+// The full factor scan must return the exact dot-product top-N, probing every IVF list must too,
+// and probing a quarter of the lists must keep most of it
+void testFactorRetrievalRecall()
+{
+    const int users = 600, items = 900, groups = 12;
+    const size_t topN = 10;
+    mt19937 rng(43);
+    vector<pair<int, int>> interactions;
+    vector<set<int>> itemsOf(users);
+    for (int user = 0; user < users; ++user)
+        for (int e = 0; e < 15; ++e)
+        {
+            // Users mostly pick items of their own taste group, so the factors have structure to find
+            int group = rng() % 4 ? user % groups : rng() % groups;
+            int item = group * (items / groups) + rng() % (items / groups);
+            interactions.push_back({user, item});
+            itemsOf[user].insert(item);
+        }
+    RecommendationSystem rs;
+    fill(rs, users, items, interactions);
+
+    ALSConfig config;
+    config.factors = 20; // Padded stride exercises the vector tail
+    config.iterations = 6;
+    config.numThreads = 2;
+    rs.trainFactors(config);
+    rs.buildFactorIndex(30, 5, 2);
+    const FactorModel &model = rs.factorModel();
+
+    size_t hits = 0, total = 0;
+    for (int user = 0; user < users; user += 5)
+    {
+        vector<pair<int, float>> exact = exactFactorTopN(model, itemsOf, user, topN);
+        vector<pair<int, float>> scanned = rs.recommendFromFactors(user, topN);
+        CHECK(scanned.size() == exact.size());
+        for (size_t i = 0; i < min(scanned.size(), exact.size()); ++i)
+            CHECK(fabs(scanned[i].second - exact[i].second) < 1e-4f * max(1.0f, fabs(exact[i].second)));
+        CHECK(rs.recommendFromFactors(user, topN, 30) == scanned);
+
+        set<int> exactItems;
+        for (const auto &entry : exact)
+            exactItems.insert(entry.first);
+        for (const auto &entry : rs.recommendFromFactors(user, topN, 8))
+        {
+            CHECK(!itemsOf[user].count(entry.first));
+            hits += exactItems.count(entry.first);
+        }
+        total += exact.size();
+    }
+    CHECK(hits >= 0.8 * total);
+}
+
+// A user holding many items must not stop early on visits to its own items
+void testRandomWalkEarlyStopIgnoresOwnedItems()
+{
+    const int users = 200, items = 400;
+    mt19937 rng(3);
+    vector<pair<int, int>> interactions;
+    for (int i = 0; i < 100; ++i)
+        interactions.push_back({0, i});
+    for (int u = 1; u < users; ++u)
+        for (int k = 0; k < 10; ++k)
+            interactions.push_back({u, int(k < 5 ? rng() % 100 : 100 + rng() % 300)});
+
+    RecommendationSystem rs;
+    fill(rs, users, items, interactions);
+    rs.buildWalkGraph();
+
+    WalkConfig config;
+    config.stepBudget = 10000000;
+    config.minVisits = 4;
+    config.settledCandidates = 50;
+    vector<pair<int, int>> result = rs.randomWalkRecommend(0, 1000, config);
+
+    int settled = 0;
+    for (const auto &entry : result)
+    {
+        CHECK(entry.first >= 100);
+        settled += entry.second >= config.minVisits;
+    }
+    CHECK(settled >= (int)config.settledCandidates);
+}
+
+// Online snapshots agree with recommendItems after every publish, with concurrent readers and writers
+void testOnlineUpdatesMatchBatchScores()
+{
+    const int users = 2500, items = 1500; // Several row chunks
+    mt19937 rng(11);
+    vector<pair<int, int>> interactions;
+    for (int k = 0; k < 6000; ++k)
+        interactions.push_back({int(rng() % users), int(rng() % items)});
+
+    RecommendationSystem rs;
+    fill(rs, users, items, interactions);
+    rs.enableOnlineUpdates(1000);
+
+    atomic<bool> stop(false);
+    vector<thread> readers;
+    for (int t = 0; t < 3; ++t)
+        readers.emplace_back([&, t]
+                             {
+                                 mt19937 local(t);
+                                 while (!stop)
+                                     rs.onlineRecommend(local() % (users + 100), 5); });
+    for (int round = 0; round < 10; ++round)
+    {
+        // Growth races with interaction writes; recommendItems is only called once writers are done
+        thread grower([&]
+                      {
+                          for (int k = 0; k < 5; ++k)
+                          {
+                              rs.addUser();
+                              rs.addItem();
+                          } });
+        for (int k = 0; k < 200; ++k)
+            rs.addInteraction(rng() % users, rng() % items);
+        grower.join();
+
+        rs.publishUpdates();
+        for (int user = 0; user < users; user += 7)
+        {
+            vector<pair<int, int>> expected = rs.recommendItems(user).items;
+            expected.resize(min<size_t>(expected.size(), 1000));
+            CHECK(rs.onlineRecommend(user, 1000) == expected);
+        }
+    }
+    stop = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    rs.publishUpdates();
+    CHECK(rs.onlineRecommend(users + 49, 5).empty());
+}
+
+int main()
+{
+    testItemSimilarityMatchesDirect();
+    testRecommendAllRoundTrip();
+    testFactorRetrievalRecall();
+    testOnlineUpdatesMatchBatchScores();
+    testRandomWalkEarlyStopIgnoresOwnedItems();
+    return reportTests("system_recommend");
+}